@@ -7,29 +7,20 @@
 #ifndef A_STAR_SEARCH_H
 #define A_STAR_SEARCH_H
 
-#include <boost/heap/binomial_heap.hpp>
-#include "SearchBase.h"
+#include "GraphSearch.h"
 
 
 using namespace std;
 
-class AStarSearch : public SearchBase
+class AStarSearch : public GraphSearch<GuidedEstimate, SumPriority>
 {
 public:
 
 	// Constructor
 	//
 
-	AStarSearch(Graph&);
-	
-	// public utility functions
-	//
-
-	virtual void search(const int, const int);
-	SearchStatus processNext();
-
-private:
-	boost::heap::binomial_heap<nodePtr, boost::heap::compare<NodeCompareHeuristic> > frontier;
+	AStarSearch(const Graph&, const Frontier::Type = Frontier::D_ARY_HEAP, const DistanceKernel::Mode = DistanceKernel::HAVERSINE);
+	AStarSearch(const Graph&, const Heuristic&, const Frontier::Type = Frontier::D_ARY_HEAP);
 };
 
 #endif /* A_STAR_SEARCH_H */
@@ -0,0 +1,112 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * BatchExecutor.cpp
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include "BatchExecutor.h"
+
+using namespace std;
+
+// queries are handed out in chunks, so the pool's locks are taken once per
+// chunk rather than once per query, but at least this many chunks go to each
+// worker, so there is something left to steal when one falls behind
+static const size_t MAX_CHUNK_SIZE = 64;
+static const size_t CHUNKS_PER_WORKER = 8;
+
+BatchExecutor::BatchExecutor(const Graph& g, const SearchFactory& makeSearch, const unsigned threads) : graph(g), pool(threads), cache(0), cacheKey(0)
+{
+	for (unsigned i = 0; i < pool.size(); ++i)
+	{
+		searches.push_back(boost::shared_ptr<SearchBase>(makeSearch()));
+	}
+	routes.resize(pool.size());
+}
+
+void BatchExecutor::run(const vector<Query>& queries, vector<float>& costs)
+{
+	checkQueries(queries);
+	costs.resize(queries.size());
+
+	pool.run(queries.size(), chunkSize(queries.size()), [this, &queries, &costs](unsigned worker, size_t begin, size_t end)
+	{
+		SearchBase& search = *searches[worker];
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (cache)
+			{
+				costs[i] = cache->findRoute(search, cacheKey, queries[i].initial, queries[i].goal, routes[worker]);
+			}
+			else
+			{
+				costs[i] = search.findRoute(queries[i].initial, queries[i].goal);
+			}
+		}
+	});
+}
+
+void BatchExecutor::run(const vector<Query>& queries, vector<Path>& paths, vector<SearchStats>& stats)
+{
+	// as above, but keeps the route and the statistics of each query as well.
+	// A query answered from the cache was not searched, so its statistics are
+	// all zero
+
+	checkQueries(queries);
+	paths.resize(queries.size());
+	stats.resize(queries.size());
+
+	pool.run(queries.size(), chunkSize(queries.size()), [this, &queries, &paths, &stats](unsigned worker, size_t begin, size_t end)
+	{
+		SearchBase& search = *searches[worker];
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (cache && cache->find(queries[i].initial, queries[i].goal, cacheKey, paths[i]))
+			{
+				stats[i] = SearchStats();
+				continue;
+			}
+
+			const uint64_t generation = cache ? cache->generation() : 0;
+			search.findRoute(queries[i].initial, queries[i].goal, paths[i]);
+			stats[i] = search.statistics();
+			if (cache)
+			{
+				cache->insert(queries[i].initial, queries[i].goal, cacheKey, paths[i], generation);
+			}
+		}
+	});
+}
+
+void BatchExecutor::useCache(RouteCache* routeCache, const uint32_t algorithm)
+{
+	// answers the queries through the cache from now on, or directly again if
+	// the cache is 0. The algorithm tells the cache which search this is
+	cache = routeCache;
+	cacheKey = algorithm;
+}
+
+unsigned BatchExecutor::threadCount() const
+{
+	return pool.size();
+}
+
+void BatchExecutor::checkQueries(const vector<Query>& queries) const
+{
+	// check every query before starting any, so a bad one does not leave
+	// the batch half done
+	for (vector<Query>::const_iterator it = queries.cbegin(); it != queries.cend(); ++it)
+	{
+		if (it->initial >= graph.nodeCount() || it->goal >= graph.nodeCount())
+		{
+			throw out_of_range("Node index out of range");
+		}
+	}
+}
+
+size_t BatchExecutor::chunkSize(const size_t queryCount) const
+{
+	const size_t size = queryCount / (size_t(pool.size()) * CHUNKS_PER_WORKER);
+	return max<size_t>(1, min(size, MAX_CHUNK_SIZE));
+}
@@ -0,0 +1,86 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * BatchExecutor.h
+ */
+
+#ifndef BATCH_EXECUTOR_H
+#define BATCH_EXECUTOR_H
+
+#include <functional>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "GraphTypes.h"
+#include "SearchBase.h"
+#include "SearchStats.h"
+#include "Path.h"
+#include "RouteCache.h"
+#include "WorkStealingPool.h"
+
+using std::vector;
+
+
+// ---------------------------------------------------------------------------------/
+// The BatchExecutor class answers a batch of route queries on one loaded Graph,	/
+// spread over the threads of a WorkStealingPool.									/
+//																					/
+// Every worker has a search object of its own, made once by the factory given		/
+// to the constructor, so any of the searches can be used (with its hierarchy or	/
+// heuristic bound into the factory). A worker answers each of its queries with		/
+// findRoute(), which re-uses the search's context and frontier, so once they		/
+// have grown to size, the queries allocate nothing.								/
+//																					/
+// The cost of each query is written to the slot of the query, so the results		/
+// come back in the order of the queries, whichever worker answered them.			/
+// run() can also keep each query's route and search statistics, for a caller		/
+// that writes out more than the costs.												/
+// Given a RouteCache, the workers answer repeated queries from it, and add the		/
+// routes they search for to it.													/
+// ---------------------------------------------------------------------------------/
+
+class BatchExecutor
+{
+public:
+
+	// a route query, from the initial node to the goal node
+	struct Query
+	{
+		nodeIndex initial;
+		nodeIndex goal;
+	};
+
+	// makes a new search object for one worker
+	typedef std::function<SearchBase*()> SearchFactory;
+
+	// Constructor
+	// a thread count of 0 starts one worker per hardware thread
+	//
+
+	explicit BatchExecutor(const Graph&, const SearchFactory&, const unsigned = 0);
+
+	// public utility functions
+	//
+
+	void run(const vector<Query>&, vector<float>&);
+	void run(const vector<Query>&, vector<Path>&, vector<SearchStats>&);
+	void useCache(RouteCache*, const std::uint32_t);
+	unsigned threadCount() const;
+
+private:
+	const Graph& graph;
+	WorkStealingPool pool;
+	vector<boost::shared_ptr<SearchBase> > searches;
+
+	// the route cache, if any, the searches' key in it, and each worker's route
+	RouteCache* cache;
+	std::uint32_t cacheKey;
+	vector<Path> routes;
+
+	// private utility functions
+	//
+
+	void checkQueries(const vector<Query>&) const;
+	std::size_t chunkSize(const std::size_t) const;
+};
+
+#endif /* BATCH_EXECUTOR_H */
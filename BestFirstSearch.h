@@ -7,29 +7,19 @@
 #ifndef BEST_FIRST_SEARCH_H
 #define BEST_FIRST_SEARCH_H
 
-#include <boost/heap/binomial_heap.hpp>
-#include "SearchBase.h"
+#include "GraphSearch.h"
 
 
 using namespace std;
 
-class BestFirstSearch : public SearchBase
+class BestFirstSearch : public GraphSearch<DistanceEstimate, EstimatePriority>
 {
 public:
 
 	// Constructor
 	//
 
-	BestFirstSearch(Graph&);
-	
-	// public utility functions
-	//
-
-	virtual void search(const int, const int);
-	SearchStatus processNext();
-
-private:
-	boost::heap::binomial_heap<nodePtr, boost::heap::compare<NodeCompareHeuristic> > frontier;
+	BestFirstSearch(const Graph&, const Frontier::Type = Frontier::D_ARY_HEAP, const DistanceKernel::Mode = DistanceKernel::HAVERSINE);
 };
 
 #endif /* BEST_FIRST_SEARCH_H */
\ No newline at end of file
@@ -0,0 +1,12 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * BidirectionalAStarSearch.cpp
+ */
+
+#include "BidirectionalAStarSearch.h"
+
+BidirectionalAStarSearch::BidirectionalAStarSearch(const Graph& g, const Frontier::Type frontierType) : BidirectionalSearch(g, true, frontierType)
+{
+	// empty constructor
+}
@@ -0,0 +1,30 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * BidirectionalAStarSearch.h
+ */
+
+#ifndef BIDIRECTIONAL_A_STAR_SEARCH_H
+#define BIDIRECTIONAL_A_STAR_SEARCH_H
+
+#include "BidirectionalSearch.h"
+
+
+using namespace std;
+
+// ---------------------------------------------------------------------------------/
+// The BidirectionalAStarSearch class is a BidirectionalSearch run as				/
+// bidirectional A*, guided by the straight line distances between nodes.			/
+// ---------------------------------------------------------------------------------/
+
+class BidirectionalAStarSearch : public BidirectionalSearch
+{
+public:
+
+	// Constructor
+	//
+
+	BidirectionalAStarSearch(const Graph&, const Frontier::Type = Frontier::D_ARY_HEAP);
+};
+
+#endif /* BIDIRECTIONAL_A_STAR_SEARCH_H */
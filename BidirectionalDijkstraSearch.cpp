@@ -0,0 +1,12 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * BidirectionalDijkstraSearch.cpp
+ */
+
+#include "BidirectionalDijkstraSearch.h"
+
+BidirectionalDijkstraSearch::BidirectionalDijkstraSearch(const Graph& g, const Frontier::Type frontierType) : BidirectionalSearch(g, false, frontierType)
+{
+	// empty constructor
+}
@@ -0,0 +1,30 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * BidirectionalDijkstraSearch.h
+ */
+
+#ifndef BIDIRECTIONAL_DIJKSTRA_SEARCH_H
+#define BIDIRECTIONAL_DIJKSTRA_SEARCH_H
+
+#include "BidirectionalSearch.h"
+
+
+using namespace std;
+
+// ---------------------------------------------------------------------------------/
+// The BidirectionalDijkstraSearch class is a BidirectionalSearch run as			/
+// bidirectional Dijkstra, which needs no coordinates.								/
+// ---------------------------------------------------------------------------------/
+
+class BidirectionalDijkstraSearch : public BidirectionalSearch
+{
+public:
+
+	// Constructor
+	//
+
+	BidirectionalDijkstraSearch(const Graph&, const Frontier::Type = Frontier::D_ARY_HEAP);
+};
+
+#endif /* BIDIRECTIONAL_DIJKSTRA_SEARCH_H */
@@ -0,0 +1,219 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * BidirectionalSearch.cpp
+ */
+
+#include <limits>
+#include "BidirectionalSearch.h"
+
+BidirectionalSearch::BidirectionalSearch(const Graph& g, const bool potentials, const Frontier::Type frontierType)
+	: SearchBase(g), usePotentials(potentials), frontier(frontierType), backwardFrontier(frontierType),
+	bestCost(0.0f), meetingNode(INVALID_NODE), potentialSum(0.0f), toGoal(g), toInitial(g)
+{
+	// empty constructor
+}
+
+void BidirectionalSearch::start()
+{
+	context.prepare(graph.nodeCount());
+	frontier.prepare(graph.nodeCount());
+	backward.prepare(graph.nodeCount());
+	backwardFrontier.prepare(graph.nodeCount());
+
+	// set the potentials that follow from the initial and goal nodes
+	toGoal.setTarget(goalNode);
+	toInitial.setTarget(initialNode);
+	potentialSum = usePotentials ? toGoal.distance(initialNode) : 0.0f;
+
+	// put the initial node in the forward frontier, and the goal node in the
+	// backward frontier, each with cost:0 and status:frontier
+	context.stateAt(initialNode).setStatus(NodeState::FRONTIER);
+	context.stateAt(initialNode).setPathCost(0.0f);
+	frontier.push(initialNode, forwardPotential(initialNode));
+
+	backward.stateAt(goalNode).setStatus(NodeState::FRONTIER);
+	backward.stateAt(goalNode).setPathCost(0.0f);
+	backwardFrontier.push(goalNode, potentialSum - forwardPotential(goalNode));
+
+	// no route is known yet, unless the initial node is the goal
+	bestCost = numeric_limits<float>::infinity();
+	meetingNode = INVALID_NODE;
+	if (initialNode == goalNode)
+	{
+		bestCost = 0.0f;
+		meetingNode = goalNode;
+	}
+}
+
+void BidirectionalSearch::collectStats()
+{
+	stats.addFrontier(frontier);
+	stats.addFrontier(backwardFrontier);
+}
+
+void BidirectionalSearch::finish()
+{
+	// clear the search state of both sides, so we can search again
+	SearchBase::finish();
+	backward.clear();
+}
+
+SearchStatus BidirectionalSearch::processNext()
+{
+	// stop once either frontier is empty, or no route through the frontiers
+	// can be shorter than the best route found so far
+	if (frontier.empty() || backwardFrontier.empty() ||
+		frontier.topKey() + backwardFrontier.topKey() >= bestCost + potentialSum)
+	{
+		// empty the frontiers so they are ready for the next search
+		frontier.clear();
+		backwardFrontier.clear();
+
+		if (meetingNode == INVALID_NODE)
+		{
+			return SearchStatus::FAILURE;
+		}
+		joinPaths();
+		return SearchStatus::SUCCESS;
+	}
+
+	// otherwise expand the side with the smaller key
+	if (frontier.topKey() <= backwardFrontier.topKey())
+	{
+		expandForward();
+	}
+	else
+	{
+		expandBackward();
+	}
+
+	// Return that we are still searching
+	return SearchStatus::SEARCHING;
+}
+
+float BidirectionalSearch::forwardPotential(const nodeIndex n)
+{
+	// the average of the forward estimate (distance to the goal) and the
+	// negated backward estimate (distance from the initial node), shifted by
+	// half their sum so it is never negative. The backward potential of a
+	// node is potentialSum less its forward potential
+
+	if (!usePotentials)
+	{
+		return 0.0f;
+	}
+	++stats.heuristicEvaluations;
+
+	return 0.5f * (toGoal.distance(n) - toInitial.distance(n) + potentialSum);
+}
+
+void BidirectionalSearch::expandForward()
+{
+	// take a node from the forward frontier, and set to explored
+	nodeIndex currentNode = frontier.pop();
+	NodeState& current = context.stateAt(currentNode);
+	current.setStatus(NodeState::EXPLORED);
+
+	const SearchContext& other = backward;
+	stats.edgesRelaxed += graph.edgesEnd(currentNode) - graph.edgesBegin(currentNode);
+
+	for( edgeIndex edge = graph.edgesBegin(currentNode); edge != graph.edgesEnd(currentNode); ++edge)
+	{
+		nodeIndex childNode = graph.edgeHead(edge);
+		NodeState& child = context.stateAt(childNode);
+		float newNodeCost = current.getPathCost() + edgeCost(edge);
+
+		// add unexplored nodes to the frontier, and update frontier nodes if a
+		// shorter path is found, as in the unidirectional searches
+		if (child.getStatus() == NodeState::UNEXPLORED)
+		{
+			child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, edge);
+			frontier.push(childNode, newNodeCost + forwardPotential(childNode));
+		}
+		else if (child.getStatus() == NodeState::FRONTIER && newNodeCost < child.getPathCost())
+		{
+			child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, edge);
+			frontier.decreaseKey(childNode, newNodeCost + forwardPotential(childNode));
+		}
+		else
+		{
+			continue;
+		}
+
+		// if the backward side has reached the child, there is a route through it
+		const NodeState& meeting = other.stateAt(childNode);
+		if (meeting.getStatus() != NodeState::UNEXPLORED && newNodeCost + meeting.getPathCost() < bestCost)
+		{
+			bestCost = newNodeCost + meeting.getPathCost();
+			meetingNode = childNode;
+		}
+	}
+}
+
+void BidirectionalSearch::expandBackward()
+{
+	// take a node from the backward frontier, and set to explored.
+	// The parent of a node on this side is the next node towards the goal,
+	// and its action the edge leading there
+	nodeIndex currentNode = backwardFrontier.pop();
+	NodeState& current = backward.stateAt(currentNode);
+	current.setStatus(NodeState::EXPLORED);
+
+	const SearchContext& other = context;
+	stats.edgesRelaxed += graph.inEdgesEnd(currentNode) - graph.inEdgesBegin(currentNode);
+
+	for( edgeIndex i = graph.inEdgesBegin(currentNode); i != graph.inEdgesEnd(currentNode); ++i)
+	{
+		edgeIndex edge = graph.inEdge(i);
+		nodeIndex childNode = graph.edgeTail(edge);
+		NodeState& child = backward.stateAt(childNode);
+		float newNodeCost = current.getPathCost() + edgeCost(edge);
+
+		if (child.getStatus() == NodeState::UNEXPLORED)
+		{
+			child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, edge);
+			backwardFrontier.push(childNode, newNodeCost + potentialSum - forwardPotential(childNode));
+		}
+		else if (child.getStatus() == NodeState::FRONTIER && newNodeCost < child.getPathCost())
+		{
+			child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, edge);
+			backwardFrontier.decreaseKey(childNode, newNodeCost + potentialSum - forwardPotential(childNode));
+		}
+		else
+		{
+			continue;
+		}
+
+		// if the forward side has reached the child, there is a route through it
+		const NodeState& meeting = other.stateAt(childNode);
+		if (meeting.getStatus() != NodeState::UNEXPLORED && meeting.getPathCost() + newNodeCost < bestCost)
+		{
+			bestCost = meeting.getPathCost() + newNodeCost;
+			meetingNode = childNode;
+		}
+	}
+}
+
+void BidirectionalSearch::joinPaths()
+{
+	// the forward states hold the route from the initial node to the meeting
+	// node, and the backward states the route on from there to the goal.
+	// Link the second half into the forward states, summing the costs from the
+	// initial node as the unidirectional searches do, so the total matches
+	// theirs and the route can be traced back along the parents from the goal
+
+	const SearchContext& other = backward;
+
+	nodeIndex currentNode = meetingNode;
+	while (currentNode != goalNode)
+	{
+		const NodeState& link = other.stateAt(currentNode);
+		nodeIndex nextNode = link.getParentNode();
+		edgeIndex edge = link.getParentAction();
+
+		float cost = context.stateAt(currentNode).getPathCost() + edgeCost(edge);
+		context.stateAt(nextNode).setSearchState(NodeState::EXPLORED, cost, currentNode, edge);
+		currentNode = nextNode;
+	}
+}
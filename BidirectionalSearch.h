@@ -0,0 +1,84 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * BidirectionalSearch.h
+ */
+
+#ifndef BIDIRECTIONAL_SEARCH_H
+#define BIDIRECTIONAL_SEARCH_H
+
+#include "SearchBase.h"
+#include "Frontier.h"
+#include "DistanceKernel.h"
+
+
+using namespace std;
+
+// ---------------------------------------------------------------------------------/
+// The BidirectionalSearch class searches forward from the initial node and			/
+// backward from the goal node at the same time, over the graph's reverse			/
+// edges, always expanding the side whose frontier has the smaller key. Each		/
+// side keeps its own SearchContext and Frontier.									/
+//																					/
+// Every time a node reached by one side is given a shorter path by the other,		/
+// the route through it is a candidate, and the shortest candidate is kept. The		/
+// search stops once the two smallest frontier keys add up to no less than the		/
+// best candidate, when no unexpanded node can lie on a shorter route.				/
+//																					/
+// With potentials, the keys of both sides are shifted by average potentials		/
+// (bidirectional A*): half the straight line distance to the goal, less half		/
+// the distance from the initial node, which keeps the two sides consistent			/
+// with each other. Without them it is bidirectional Dijkstra. The subclasses		/
+// BidirectionalDijkstraSearch and BidirectionalAStarSearch pick one.				/
+// ---------------------------------------------------------------------------------/
+
+class BidirectionalSearch : public SearchBase
+{
+public:
+
+	// public utility functions
+	//
+
+	virtual SearchStatus processNext();
+
+protected:
+
+	// Constructor
+	//
+
+	BidirectionalSearch(const Graph&, const bool, const Frontier::Type);
+
+	virtual void start();
+	virtual void collectStats();
+	virtual void finish();
+
+private:
+	bool usePotentials;
+
+	// the forward side uses SearchBase's context
+	Frontier frontier;
+	SearchContext backward;
+	Frontier backwardFrontier;
+
+	// the shortest route found so far, and where its two halves meet
+	float bestCost;
+	nodeIndex meetingNode;
+
+	// the straight line distance from the initial node to the goal,
+	// which is what the two potentials of any node add up to
+	float potentialSum;
+
+	// straight line distances to the goal, and to the initial node
+	DistanceKernel toGoal;
+	DistanceKernel toInitial;
+
+	// private utility functions
+	//
+
+	float forwardPotential(const nodeIndex);
+	void expandForward();
+	void expandBackward();
+	void joinPaths();
+};
+
+#endif /* BIDIRECTIONAL_SEARCH_H */
@@ -0,0 +1,400 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * ContractionHierarchy.cpp
+ */
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+#include "ContractionHierarchy.h"
+#include "SearchContext.h"
+#include "Frontier.h"
+
+using namespace std;
+
+// a witness search gives up after settling this many nodes, and a shortcut
+// is added. That can only add shortcuts that are not needed, never miss one
+static const unsigned WITNESS_SETTLE_LIMIT = 500;
+
+// ---------------------------------------------------------------------------------/
+// The Builder holds the graph that remains while nodes are contracted: the arcs	/
+// in and out of every node not yet contracted, and a witness search over them.		/
+// ---------------------------------------------------------------------------------/
+
+class ContractionHierarchy::Builder
+{
+public:
+	Builder(vector<Arc>&, const nodeIndex);
+
+	int priority(const nodeIndex);
+	void contract(const nodeIndex);
+
+private:
+	// a neighbour of the node being contracted, and the cheapest arc to or from it
+	struct Neighbour
+	{
+		nodeIndex node;
+		float cost;
+		std::uint32_t arc;
+
+		bool operator<(const Neighbour& other) const
+		{
+			return node < other.node || (node == other.node && cost < other.cost);
+		}
+	};
+
+	vector<Arc>& arcs;
+	vector<vector<std::uint32_t> > outArcs;
+	vector<vector<std::uint32_t> > inArcs;
+	vector<std::uint32_t> contractedNeighbours;
+	vector<std::uint32_t> depth;
+
+	SearchContext witness;
+	Frontier witnessFrontier;
+	vector<Neighbour> ins;
+	vector<Neighbour> outs;
+	vector<std::uint8_t> isTarget;
+
+	std::uint32_t findShortcuts(const nodeIndex, const bool);
+	void collectNeighbours(const nodeIndex);
+	void witnessSearch(const nodeIndex, const nodeIndex, const float, unsigned);
+	static void removeArc(vector<std::uint32_t>&, const std::uint32_t);
+};
+
+ContractionHierarchy::Builder::Builder(vector<Arc>& a, const nodeIndex nodeCount)
+	: arcs(a), outArcs(nodeCount), inArcs(nodeCount), contractedNeighbours(nodeCount, 0), depth(nodeCount, 0), isTarget(nodeCount, 0)
+{
+	for (uint32_t id = 0; id < arcs.size(); ++id)
+	{
+		outArcs[arcs[id].tail].push_back(id);
+		inArcs[arcs[id].head].push_back(id);
+	}
+	witness.prepare(nodeCount);
+	witnessFrontier.prepare(nodeCount);
+}
+
+int ContractionHierarchy::Builder::priority(const nodeIndex v)
+{
+	// the edge difference of contracting the node now, plus the number
+	// of its neighbours that have been contracted already
+
+	const int shortcuts = int(findShortcuts(v, false));
+	const int removed = int(outArcs[v].size() + inArcs[v].size());
+	return 2 * (shortcuts - removed) + int(contractedNeighbours[v]) + int(depth[v]);
+}
+
+void ContractionHierarchy::Builder::contract(const nodeIndex v)
+{
+	// adds the shortcuts the node needs, then takes it out of the remaining graph
+
+	findShortcuts(v, true);
+
+	for (vector<uint32_t>::const_iterator it = outArcs[v].cbegin(); it != outArcs[v].cend(); ++it)
+	{
+		removeArc(inArcs[arcs[*it].head], *it);
+		++contractedNeighbours[arcs[*it].head];
+		depth[arcs[*it].head] = max(depth[arcs[*it].head], depth[v] + 1);
+	}
+	for (vector<uint32_t>::const_iterator it = inArcs[v].cbegin(); it != inArcs[v].cend(); ++it)
+	{
+		removeArc(outArcs[arcs[*it].tail], *it);
+		++contractedNeighbours[arcs[*it].tail];
+		depth[arcs[*it].tail] = max(depth[arcs[*it].tail], depth[v] + 1);
+	}
+	vector<uint32_t>().swap(outArcs[v]);
+	vector<uint32_t>().swap(inArcs[v]);
+}
+
+uint32_t ContractionHierarchy::Builder::findShortcuts(const nodeIndex v, const bool add)
+{
+	// counts the shortcuts needed to contract the node, and adds them if asked.
+	// For every neighbour u with an arc into the node, a witness search from u
+	// looks for routes that avoid the node; a shortcut u->w is needed for every
+	// neighbour w it did not reach at least as cheaply as through the node
+
+	collectNeighbours(v);
+	const SearchContext& found = witness;
+	uint32_t count = 0;
+
+	for (vector<Neighbour>::const_iterator out = outs.cbegin(); out != outs.cend(); ++out)
+	{
+		isTarget[out->node] = 1;
+	}
+
+	for (vector<Neighbour>::const_iterator in = ins.cbegin(); in != ins.cend(); ++in)
+	{
+		float limit = -1.0f;
+		unsigned targets = 0;
+		for (vector<Neighbour>::const_iterator out = outs.cbegin(); out != outs.cend(); ++out)
+		{
+			if (out->node != in->node)
+			{
+				limit = max(limit, in->cost + out->cost);
+				++targets;
+			}
+		}
+		if (targets == 0)
+		{
+			continue;
+		}
+
+		witnessSearch(in->node, v, limit, targets);
+
+		for (vector<Neighbour>::const_iterator out = outs.cbegin(); out != outs.cend(); ++out)
+		{
+			const float viaCost = in->cost + out->cost;
+			const NodeState& state = found.stateAt(out->node);
+			if (out->node == in->node ||
+				(state.getStatus() != NodeState::UNEXPLORED && state.getPathCost() <= viaCost))
+			{
+				continue;
+			}
+
+			++count;
+			if (add)
+			{
+				const Arc shortcut = { in->node, out->node, viaCost, in->arc, out->arc };
+				const uint32_t id = uint32_t(arcs.size());
+				arcs.push_back(shortcut);
+				outArcs[in->node].push_back(id);
+				inArcs[out->node].push_back(id);
+			}
+		}
+	}
+
+	for (vector<Neighbour>::const_iterator out = outs.cbegin(); out != outs.cend(); ++out)
+	{
+		isTarget[out->node] = 0;
+	}
+	return count;
+}
+
+void ContractionHierarchy::Builder::collectNeighbours(const nodeIndex v)
+{
+	// lists the node's neighbours in each direction, once each,
+	// with the cheapest of any parallel arcs
+
+	ins.clear();
+	outs.clear();
+	for (vector<uint32_t>::const_iterator it = inArcs[v].cbegin(); it != inArcs[v].cend(); ++it)
+	{
+		const Neighbour n = { arcs[*it].tail, arcs[*it].cost, *it };
+		ins.push_back(n);
+	}
+	for (vector<uint32_t>::const_iterator it = outArcs[v].cbegin(); it != outArcs[v].cend(); ++it)
+	{
+		const Neighbour n = { arcs[*it].head, arcs[*it].cost, *it };
+		outs.push_back(n);
+	}
+
+	vector<Neighbour>* lists[2] = { &ins, &outs };
+	for (int l = 0; l < 2; ++l)
+	{
+		vector<Neighbour>& list = *lists[l];
+		sort(list.begin(), list.end());
+		vector<Neighbour>::iterator last = list.begin();
+		for (vector<Neighbour>::iterator it = list.begin(); it != list.end(); ++it)
+		{
+			if (it == list.begin() || it->node != (last - 1)->node)
+			{
+				*last++ = *it;
+			}
+		}
+		list.erase(last, list.end());
+	}
+}
+
+void ContractionHierarchy::Builder::witnessSearch(const nodeIndex from, const nodeIndex avoid, const float limit, unsigned targets)
+{
+	// a uniform cost search from a neighbour, that never enters the node being
+	// contracted, and stops at routes longer than the limit, or once all the
+	// target neighbours are settled. Its path costs are left in the witness
+	// context for findShortcuts() to read
+
+	witness.clear();
+	witnessFrontier.prepare(nodeIndex(outArcs.size()));
+
+	witness.stateAt(from).setStatus(NodeState::FRONTIER);
+	witness.stateAt(from).setPathCost(0.0f);
+	witnessFrontier.push(from, 0.0f);
+
+	unsigned settled = 0;
+	while (targets > 0 && !witnessFrontier.empty() && settled < WITNESS_SETTLE_LIMIT && witnessFrontier.topKey() <= limit)
+	{
+		const nodeIndex currentNode = witnessFrontier.pop();
+		NodeState& current = witness.stateAt(currentNode);
+		current.setStatus(NodeState::EXPLORED);
+		++settled;
+		if (isTarget[currentNode] && currentNode != from)
+		{
+			--targets;
+		}
+
+		for (vector<uint32_t>::const_iterator it = outArcs[currentNode].cbegin(); it != outArcs[currentNode].cend(); ++it)
+		{
+			const nodeIndex childNode = arcs[*it].head;
+			if (childNode == avoid)
+			{
+				continue;
+			}
+
+			NodeState& child = witness.stateAt(childNode);
+			const float newNodeCost = current.getPathCost() + arcs[*it].cost;
+			if (child.getStatus() == NodeState::UNEXPLORED)
+			{
+				child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, INVALID_EDGE);
+				witnessFrontier.push(childNode, newNodeCost);
+			}
+			else if (child.getStatus() == NodeState::FRONTIER && newNodeCost < child.getPathCost())
+			{
+				child.setPathCost(newNodeCost);
+				witnessFrontier.decreaseKey(childNode, newNodeCost);
+			}
+		}
+	}
+}
+
+void ContractionHierarchy::Builder::removeArc(vector<uint32_t>& list, const uint32_t arc)
+{
+	vector<uint32_t>::iterator it = find(list.begin(), list.end(), arc);
+	if (it != list.end())
+	{
+		*it = list.back();
+		list.pop_back();
+	}
+}
+
+ContractionHierarchy::ContractionHierarchy(const Graph& graph) : originalArcCount(0)
+{
+	// one arc per edge of the graph. Self loops are left out, as they are
+	// never on a shortest route
+
+	const nodeIndex numNodes = graph.nodeCount();
+	for (edgeIndex e = 0; e < graph.edgeCount(); ++e)
+	{
+		if (graph.edgeTail(e) != graph.edgeHead(e))
+		{
+			const Arc arc = { graph.edgeTail(e), graph.edgeHead(e), graph.edgeCost(e), e, NO_ARC };
+			arcs.push_back(arc);
+		}
+	}
+	originalArcCount = uint32_t(arcs.size());
+
+	// contract the nodes in order of priority, smallest first, with lazy updates
+	Builder builder(arcs, numNodes);
+	priority_queue<pair<int, nodeIndex>, vector<pair<int, nodeIndex> >, greater<pair<int, nodeIndex> > > queue;
+	for (nodeIndex n = 0; n < numNodes; ++n)
+	{
+		queue.push(make_pair(builder.priority(n), n));
+	}
+
+	rank.assign(numNodes, 0);
+	nodeIndex nextRank = 0;
+	while (!queue.empty())
+	{
+		const nodeIndex n = queue.top().second;
+		queue.pop();
+
+		const int current = builder.priority(n);
+		if (!queue.empty() && current > queue.top().first)
+		{
+			queue.push(make_pair(current, n));
+			continue;
+		}
+
+		builder.contract(n);
+		rank[n] = nextRank++;
+	}
+
+	buildSearchArcs();
+}
+
+nodeIndex ContractionHierarchy::nodeCount() const
+{
+	return nodeIndex(rank.size());
+}
+
+uint32_t ContractionHierarchy::arcCount() const
+{
+	return uint32_t(arcs.size());
+}
+
+uint32_t ContractionHierarchy::shortcutCount() const
+{
+	return uint32_t(arcs.size()) - originalArcCount;
+}
+
+nodeIndex ContractionHierarchy::rankOf(const nodeIndex n) const
+{
+	return rank[n];
+}
+
+void ContractionHierarchy::unpack(const uint32_t arc, vector<edgeIndex>& edges, vector<uint32_t>& pending) const
+{
+	// appends the graph edges an arc stands for, in route order,
+	// expanding shortcuts with a stack rather than recursion. The stack is
+	// the caller's, so a search can keep it from one query to the next
+
+	pending.assign(1, arc);
+	while (!pending.empty())
+	{
+		const Arc& a = arcs[pending.back()];
+		pending.pop_back();
+		if (a.second == NO_ARC)
+		{
+			edges.push_back(a.first);
+		}
+		else
+		{
+			pending.push_back(a.second);
+			pending.push_back(a.first);
+		}
+	}
+}
+
+void ContractionHierarchy::buildSearchArcs()
+{
+	// packs the arcs into the upward and downward CSR lists, with a
+	// counting sort on the node each is scanned from
+
+	const nodeIndex numNodes = nodeCount();
+	upOffset.assign(numNodes + 1, 0);
+	downOffset.assign(numNodes + 1, 0);
+	for (vector<Arc>::const_iterator it = arcs.cbegin(); it != arcs.cend(); ++it)
+	{
+		if (rank[it->tail] < rank[it->head])
+		{
+			++upOffset[it->tail + 1];
+		}
+		else
+		{
+			++downOffset[it->head + 1];
+		}
+	}
+	for (nodeIndex n = 0; n < numNodes; ++n)
+	{
+		upOffset[n + 1] += upOffset[n];
+		downOffset[n + 1] += downOffset[n];
+	}
+
+	upList.resize(upOffset[numNodes]);
+	downList.resize(downOffset[numNodes]);
+	vector<uint32_t> nextUp(upOffset.begin(), upOffset.end() - 1);
+	vector<uint32_t> nextDown(downOffset.begin(), downOffset.end() - 1);
+	for (uint32_t id = 0; id < arcs.size(); ++id)
+	{
+		const Arc& a = arcs[id];
+		if (rank[a.tail] < rank[a.head])
+		{
+			const SearchArc up = { a.head, a.cost, id };
+			upList[nextUp[a.tail]++] = up;
+		}
+		else
+		{
+			const SearchArc down = { a.tail, a.cost, id };
+			downList[nextDown[a.head]++] = down;
+		}
+	}
+}
@@ -0,0 +1,113 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * ContractionHierarchy.h
+ */
+
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include <cstdint>
+#include <vector>
+#include "GraphTypes.h"
+#include "Graph.h"
+
+using std::vector;
+
+
+// ---------------------------------------------------------------------------------/
+// The ContractionHierarchy class preprocesses a Graph for fast shortest route		/
+// queries, see ContractionHierarchySearch.											/
+//																					/
+// Nodes are contracted one at a time, in order of importance: contracting a node	/
+// removes it from the remaining graph, and adds a shortcut arc u->w for every		/
+// pair of its neighbours u->v->w whose route through it is the only shortest		/
+// one. A local "witness" search from u, that avoids v, decides whether another		/
+// route is as short. The next node to contract is the one with the smallest		/
+// priority: twice its edge difference (shortcuts added less arcs removed), plus	/
+// the number of its neighbours already contracted and its depth in the				/
+// hierarchy so far, which spread the contraction evenly over the graph.			/
+// Priorities are updated lazily: a node's priority is recomputed when it comes		/
+// to the front of the queue, and it is put back if it is no longer the smallest.	/
+//																					/
+// A node's rank is its position in the contraction order. Every arc, original		/
+// or shortcut, is stored once, as an upward arc at its tail when its head has		/
+// the higher rank, or as a downward arc at its head otherwise, so a query only		/
+// ever searches upwards from both ends. A shortcut remembers the two arcs it		/
+// replaces, so routes can be unpacked back into the graph's edges.					/
+// ---------------------------------------------------------------------------------/
+
+class ContractionHierarchy
+{
+public:
+
+	// an arc as seen by the search that scans it: the node at its other end,
+	// its cost, and its index, for unpacking
+	struct SearchArc
+	{
+		nodeIndex node;
+		float cost;
+		std::uint32_t arc;
+	};
+
+	static constexpr std::uint32_t NO_ARC = 0xFFFFFFFFu;
+
+	// Constructor, which does the preprocessing
+	//
+
+	explicit ContractionHierarchy(const Graph&);
+
+	// public utility functions
+	//
+
+	nodeIndex nodeCount() const;
+	std::uint32_t arcCount() const;
+	std::uint32_t shortcutCount() const;
+	nodeIndex rankOf(const nodeIndex) const;
+	void unpack(const std::uint32_t, vector<edgeIndex>&, vector<std::uint32_t>&) const;
+
+	// The arcs are scanned on every step of a query,
+	// so the accessors are inlined.
+	// Upward arcs leave node n towards higher ranks, downward arcs enter node n
+	// from higher ranks, and are scanned backwards from the goal
+
+	std::uint32_t upBegin(const nodeIndex n) const { return upOffset[n]; }
+	std::uint32_t upEnd(const nodeIndex n) const { return upOffset[n + 1]; }
+	const SearchArc& upArc(const std::uint32_t i) const { return upList[i]; }
+
+	std::uint32_t downBegin(const nodeIndex n) const { return downOffset[n]; }
+	std::uint32_t downEnd(const nodeIndex n) const { return downOffset[n + 1]; }
+	const SearchArc& downArc(const std::uint32_t i) const { return downList[i]; }
+
+private:
+	// every arc of the hierarchy. An original arc has the graph's edge index
+	// in first and NO_ARC in second, a shortcut the indices of the two arcs
+	// it replaces
+	struct Arc
+	{
+		nodeIndex tail;
+		nodeIndex head;
+		float cost;
+		std::uint32_t first;
+		std::uint32_t second;
+	};
+
+	vector<Arc> arcs;
+	std::uint32_t originalArcCount;
+	vector<nodeIndex> rank;
+
+	vector<std::uint32_t> upOffset;
+	vector<SearchArc> upList;
+	vector<std::uint32_t> downOffset;
+	vector<SearchArc> downList;
+
+	// the remaining graph during contraction, see ContractionHierarchy.cpp
+	class Builder;
+
+	// private utility functions
+	//
+
+	void buildSearchArcs();
+};
+
+#endif /* CONTRACTION_HIERARCHY_H */
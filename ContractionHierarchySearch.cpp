@@ -0,0 +1,204 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * ContractionHierarchySearch.cpp
+ */
+
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include "ContractionHierarchySearch.h"
+
+ContractionHierarchySearch::ContractionHierarchySearch(const Graph& g, const ContractionHierarchy& h, const Frontier::Type frontierType)
+	: SearchBase(g), hierarchy(h), frontier(frontierType), backwardFrontier(frontierType),
+	bestCost(0.0f), meetingNode(INVALID_NODE)
+{
+	// empty constructor
+}
+
+void ContractionHierarchySearch::start()
+{
+	// check that the hierarchy was built for this graph before touching it
+	if (hierarchy.nodeCount() != graph.nodeCount())
+	{
+		throw runtime_error("Contraction hierarchy does not match the graph");
+	}
+
+	context.prepare(graph.nodeCount());
+	frontier.prepare(graph.nodeCount());
+	backward.prepare(graph.nodeCount());
+	backwardFrontier.prepare(graph.nodeCount());
+
+	// put the initial node in the forward frontier, and the goal node in the
+	// backward frontier, each with cost:0 and status:frontier
+	context.stateAt(initialNode).setStatus(NodeState::FRONTIER);
+	context.stateAt(initialNode).setPathCost(0.0f);
+	frontier.push(initialNode, 0.0f);
+
+	backward.stateAt(goalNode).setStatus(NodeState::FRONTIER);
+	backward.stateAt(goalNode).setPathCost(0.0f);
+	backwardFrontier.push(goalNode, 0.0f);
+
+	bestCost = numeric_limits<float>::infinity();
+	meetingNode = INVALID_NODE;
+}
+
+void ContractionHierarchySearch::collectStats()
+{
+	stats.addFrontier(frontier);
+	stats.addFrontier(backwardFrontier);
+}
+
+void ContractionHierarchySearch::finish()
+{
+	// clear the search state of both sides, so we can search again
+	SearchBase::finish();
+	backward.clear();
+}
+
+SearchStatus ContractionHierarchySearch::processNext()
+{
+	// a side is finished once its frontier is empty, or its smallest key is
+	// no less than the best route found so far
+	const bool forwardOpen = !frontier.empty() && frontier.topKey() < bestCost;
+	const bool backwardOpen = !backwardFrontier.empty() && backwardFrontier.topKey() < bestCost;
+
+	if (!forwardOpen && !backwardOpen)
+	{
+		// empty the frontiers so they are ready for the next search
+		frontier.clear();
+		backwardFrontier.clear();
+
+		if (meetingNode == INVALID_NODE)
+		{
+			return SearchStatus::FAILURE;
+		}
+		unpackPath();
+		return SearchStatus::SUCCESS;
+	}
+
+	// otherwise expand the open side with the smaller key
+	if (forwardOpen && (!backwardOpen || frontier.topKey() <= backwardFrontier.topKey()))
+	{
+		expandForward();
+	}
+	else
+	{
+		expandBackward();
+	}
+
+	// Return that we are still searching
+	return SearchStatus::SEARCHING;
+}
+
+void ContractionHierarchySearch::expandForward()
+{
+	// take a node from the forward frontier, and set to explored
+	nodeIndex currentNode = frontier.pop();
+	NodeState& current = context.stateAt(currentNode);
+	current.setStatus(NodeState::EXPLORED);
+
+	// if the backward side has reached the node, there is a route through it
+	const SearchContext& other = backward;
+	const NodeState& meeting = other.stateAt(currentNode);
+	if (meeting.getStatus() != NodeState::UNEXPLORED && current.getPathCost() + meeting.getPathCost() < bestCost)
+	{
+		bestCost = current.getPathCost() + meeting.getPathCost();
+		meetingNode = currentNode;
+	}
+
+	// the action of a node is the hierarchy arc it was reached by
+	stats.edgesRelaxed += hierarchy.upEnd(currentNode) - hierarchy.upBegin(currentNode);
+	for( uint32_t i = hierarchy.upBegin(currentNode); i != hierarchy.upEnd(currentNode); ++i)
+	{
+		const ContractionHierarchy::SearchArc& arc = hierarchy.upArc(i);
+		NodeState& child = context.stateAt(arc.node);
+		float newNodeCost = current.getPathCost() + arc.cost;
+
+		if (child.getStatus() == NodeState::UNEXPLORED)
+		{
+			child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, arc.arc);
+			frontier.push(arc.node, newNodeCost);
+		}
+		else if (child.getStatus() == NodeState::FRONTIER && newNodeCost < child.getPathCost())
+		{
+			child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, arc.arc);
+			frontier.decreaseKey(arc.node, newNodeCost);
+		}
+	}
+}
+
+void ContractionHierarchySearch::expandBackward()
+{
+	// take a node from the backward frontier, and set to explored.
+	// The parent of a node on this side is the next node towards the goal
+	nodeIndex currentNode = backwardFrontier.pop();
+	NodeState& current = backward.stateAt(currentNode);
+	current.setStatus(NodeState::EXPLORED);
+
+	// if the forward side has reached the node, there is a route through it
+	const SearchContext& other = context;
+	const NodeState& meeting = other.stateAt(currentNode);
+	if (meeting.getStatus() != NodeState::UNEXPLORED && meeting.getPathCost() + current.getPathCost() < bestCost)
+	{
+		bestCost = meeting.getPathCost() + current.getPathCost();
+		meetingNode = currentNode;
+	}
+
+	stats.edgesRelaxed += hierarchy.downEnd(currentNode) - hierarchy.downBegin(currentNode);
+	for( uint32_t i = hierarchy.downBegin(currentNode); i != hierarchy.downEnd(currentNode); ++i)
+	{
+		const ContractionHierarchy::SearchArc& arc = hierarchy.downArc(i);
+		NodeState& child = backward.stateAt(arc.node);
+		float newNodeCost = current.getPathCost() + arc.cost;
+
+		if (child.getStatus() == NodeState::UNEXPLORED)
+		{
+			child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, arc.arc);
+			backwardFrontier.push(arc.node, newNodeCost);
+		}
+		else if (child.getStatus() == NodeState::FRONTIER && newNodeCost < child.getPathCost())
+		{
+			child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, arc.arc);
+			backwardFrontier.decreaseKey(arc.node, newNodeCost);
+		}
+	}
+}
+
+void ContractionHierarchySearch::unpackPath()
+{
+	// collects the hierarchy arcs of the route, up from the initial node to the
+	// meeting node and down from there to the goal, and unpacks them into the
+	// graph's edges. The edges are then recorded in the forward states, with
+	// costs summed from the initial node as the unidirectional searches do, so
+	// the route can be traced back along the parents from the goal
+
+	const SearchContext& forwardStates = context;
+	const SearchContext& backwardStates = backward;
+	routeArcs.clear();
+
+	for (nodeIndex n = meetingNode; n != initialNode; n = forwardStates.stateAt(n).getParentNode())
+	{
+		routeArcs.push_back(forwardStates.stateAt(n).getParentAction());
+	}
+	reverse(routeArcs.begin(), routeArcs.end());
+	for (nodeIndex n = meetingNode; n != goalNode; n = backwardStates.stateAt(n).getParentNode())
+	{
+		routeArcs.push_back(backwardStates.stateAt(n).getParentAction());
+	}
+
+	routeEdges.clear();
+	for (vector<uint32_t>::const_iterator it = routeArcs.cbegin(); it != routeArcs.cend(); ++it)
+	{
+		hierarchy.unpack(*it, routeEdges, pendingArcs);
+	}
+
+	nodeIndex currentNode = initialNode;
+	for (vector<edgeIndex>::const_iterator it = routeEdges.cbegin(); it != routeEdges.cend(); ++it)
+	{
+		nodeIndex nextNode = graph.edgeHead(*it);
+		float cost = context.stateAt(currentNode).getPathCost() + edgeCost(*it);
+		context.stateAt(nextNode).setSearchState(NodeState::EXPLORED, cost, currentNode, *it);
+		currentNode = nextNode;
+	}
+}
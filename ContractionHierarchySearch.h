@@ -0,0 +1,75 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * ContractionHierarchySearch.h
+ */
+
+#ifndef CONTRACTION_HIERARCHY_SEARCH_H
+#define CONTRACTION_HIERARCHY_SEARCH_H
+
+#include "SearchBase.h"
+#include "Frontier.h"
+#include "ContractionHierarchy.h"
+
+
+using namespace std;
+
+// ---------------------------------------------------------------------------------/
+// The ContractionHierarchySearch class answers queries on a preprocessed			/
+// ContractionHierarchy. It searches upwards from the initial node over the			/
+// upward arcs, and upwards from the goal over the downward arcs, so both			/
+// sides only move to more important nodes, and meet at the highest node of			/
+// the route. Each side stops once its smallest key is no less than the best		/
+// route found through a node both have reached.									/
+//																					/
+// The route found is made of hierarchy arcs; they are unpacked into the			/
+// graph's edges, so the Path found lists the same edge by edge route as the		/
+// other searches.																	/
+// ---------------------------------------------------------------------------------/
+
+class ContractionHierarchySearch : public SearchBase
+{
+public:
+
+	// Constructor
+	//
+
+	ContractionHierarchySearch(const Graph&, const ContractionHierarchy&, const Frontier::Type = Frontier::D_ARY_HEAP);
+
+	// public utility functions
+	//
+
+	virtual SearchStatus processNext();
+
+protected:
+	virtual void start();
+	virtual void collectStats();
+	virtual void finish();
+
+private:
+	const ContractionHierarchy& hierarchy;
+
+	// the forward side uses SearchBase's context
+	Frontier frontier;
+	SearchContext backward;
+	Frontier backwardFrontier;
+
+	// the shortest route found so far, and the node where its two halves meet
+	float bestCost;
+	nodeIndex meetingNode;
+
+	// the arcs and edges of the route being unpacked, and the stack of arcs
+	// still to unpack, kept so a query does not allocate them
+	vector<std::uint32_t> routeArcs;
+	vector<edgeIndex> routeEdges;
+	vector<std::uint32_t> pendingArcs;
+
+	// private utility functions
+	//
+
+	void expandForward();
+	void expandBackward();
+	void unpackPath();
+};
+
+#endif /* CONTRACTION_HIERARCHY_SEARCH_H */
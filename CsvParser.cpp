@@ -0,0 +1,130 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * CsvParser.cpp
+ */
+
+#include <charconv>
+#include "CsvParser.h"
+
+using namespace std;
+
+int CsvParser::split(string_view line, string_view* fields, const int maxFields)
+{
+	// splits the line at every comma outside of quotation marks, storing up to
+	// maxFields fields. Returns the number of fields in the line, which may be
+	// more than maxFields, or -1 if the line has a bad escape sequence
+
+	// the unescaped fields together are never longer than the line, so after
+	// this reserve the scratch buffer never moves while the line is split
+	scratch.clear();
+	scratch.reserve(line.size());
+
+	int count = 0;
+	size_t pos = 0;
+	for (;;)
+	{
+		// fast path : scan a plain field, that can be returned as a view of the line
+		size_t start = pos;
+		while (pos < line.size() && line[pos] != ',' && line[pos] != '"' && line[pos] != '\\')
+		{
+			++pos;
+		}
+
+		string_view field = line.substr(start, pos - start);
+		if (pos < line.size() && line[pos] != ',')
+		{
+			// slow path : the field has quotes or escapes, unescape it from the start
+			pos = start;
+			if (!unescapeField(line, pos, field))
+			{
+				return -1;
+			}
+		}
+
+		if (count < maxFields)
+		{
+			fields[count] = field;
+		}
+		++count;
+
+		// pos is now at the comma after the field, or at the end of the line
+		if (pos == line.size())
+		{
+			return count;
+		}
+		++pos;
+	}
+}
+
+bool CsvParser::parseFloat(string_view field, float& value)
+{
+	// converts the whole field to a float, returns false if the field is not a
+	// number or has anything after the number. A leading '+' is accepted, to
+	// match what lexical_cast accepted
+
+	const char* first = field.data();
+	const char* last = field.data() + field.size();
+	if (first != last && *first == '+')
+	{
+		++first;
+		if (first != last && *first == '-')
+		{
+			return false;
+		}
+	}
+
+	from_chars_result result = from_chars(first, last, value);
+	return result.ec == errc() && result.ptr == last;
+}
+
+bool CsvParser::unescapeField(string_view line, size_t& pos, string_view& field)
+{
+	// copies the field starting at pos into the scratch buffer, removing quotes
+	// and resolving escapes, and leaves pos at the comma that ends the field or
+	// at the end of the line
+
+	const size_t start = scratch.size();
+	bool inQuote = false;
+
+	while (pos < line.size())
+	{
+		char c = line[pos];
+		if (c == '\\')
+		{
+			if (++pos == line.size())
+			{
+				return false;
+			}
+			c = line[pos];
+			if (c == 'n')
+			{
+				scratch.push_back('\n');
+			}
+			else if (c == '\\' || c == '"' || c == ',')
+			{
+				scratch.push_back(c);
+			}
+			else
+			{
+				return false;
+			}
+		}
+		else if (c == '"')
+		{
+			inQuote = !inQuote;
+		}
+		else if (c == ',' && !inQuote)
+		{
+			break;
+		}
+		else
+		{
+			scratch.push_back(c);
+		}
+		++pos;
+	}
+
+	field = string_view(scratch.data() + start, scratch.size() - start);
+	return true;
+}
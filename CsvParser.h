@@ -0,0 +1,48 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * CsvParser.h
+ */
+
+#ifndef CSV_PARSER_H
+#define CSV_PARSER_H
+
+#include <string>
+#include <string_view>
+
+using std::string;
+using std::string_view;
+
+
+// ---------------------------------------------------------------------------------/
+// The CsvParser class splits a line of comma separated values into fields, and		/
+// converts fields to numbers, without allocating per line.							/
+//																					/
+// It follows the rules of boost's escaped_list_separator, which the graph files	/
+// were written for: a field may be enclosed in quotation marks to include commas,	/
+// and a backslash escapes a quote, comma, backslash, or 'n' for a newline.			/
+// Plain fields are returned as views into the line itself. Fields that need		/
+// unescaping are written to a scratch buffer owned by the parser, so the views		/
+// are valid until the next call to split(), or as long as the line, if sooner.		/
+// ---------------------------------------------------------------------------------/
+
+class CsvParser
+{
+public:
+
+	// public utility functions
+	//
+
+	int split(string_view, string_view*, const int);
+	static bool parseFloat(string_view, float&);
+
+private:
+	string scratch;
+
+	// private utility functions
+	//
+
+	bool unescapeField(string_view, std::size_t&, string_view&);
+};
+
+#endif /* CSV_PARSER_H */
@@ -0,0 +1,273 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * CustomizableHierarchy.cpp
+ */
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include "CustomizableHierarchy.h"
+
+using namespace std;
+
+// marks a graph edge that runs down its arc, from the higher node to the lower
+static const uint32_t DOWNWARD_EDGE = 0x80000000u;
+
+CustomizableHierarchy::CustomizableHierarchy(const Graph& g) : graph(g)
+{
+	// edges and nodes share the top bit of a via with VIA_NODE
+	if (g.nodeCount() >= VIA_NODE || g.edgeCount() >= VIA_NODE)
+	{
+		throw out_of_range("Graph too large for a customizable hierarchy");
+	}
+
+	orderNodes();
+	mapEdges();
+	customize();
+}
+
+nodeIndex CustomizableHierarchy::nodeCount() const
+{
+	return nodeIndex(rank.size());
+}
+
+uint32_t CustomizableHierarchy::arcCount() const
+{
+	return uint32_t(arcHeadList.size());
+}
+
+nodeIndex CustomizableHierarchy::rankOf(const nodeIndex n) const
+{
+	return rank.at(n);
+}
+
+void CustomizableHierarchy::customize()
+{
+	// works out the arc costs for the graph's current edge costs. Taking the
+	// nodes in order means both arcs of a route x->v->y are final before it is
+	// tried, as their own routes only go through nodes before v
+
+	boost::shared_ptr<Metric> m(new Metric);
+	m->edgeCosts = graph.costTable();
+	const float* costs = m->edgeCosts->data();
+
+	m->upCost.assign(arcCount(), numeric_limits<float>::infinity());
+	m->downCost.assign(arcCount(), numeric_limits<float>::infinity());
+	m->upVia.assign(arcCount(), NO_VIA);
+	m->downVia.assign(arcCount(), NO_VIA);
+
+	// each arc starts with its cheapest edge each way
+	for (edgeIndex e = 0; e < edgeArc.size(); ++e)
+	{
+		if (edgeArc[e] == NO_VIA)
+		{
+			continue;
+		}
+		const uint32_t arc = edgeArc[e] & ~DOWNWARD_EDGE;
+		const bool down = (edgeArc[e] & DOWNWARD_EDGE) != 0;
+		float& cost = down ? m->downCost[arc] : m->upCost[arc];
+		if (costs[e] < cost)
+		{
+			cost = costs[e];
+			(down ? m->downVia[arc] : m->upVia[arc]) = e;
+		}
+	}
+
+	for (vector<nodeIndex>::const_iterator v = byRank.cbegin(); v != byRank.cend(); ++v)
+	{
+		for (uint32_t i = arcOffset[*v]; i != arcOffset[*v + 1]; ++i)
+		{
+			for (uint32_t j = i + 1; j != arcOffset[*v + 1]; ++j)
+			{
+				// the arc between the two higher nodes is at the lower of them, x
+				uint32_t x = i;
+				uint32_t y = j;
+				if (rank[arcHeadList[x]] > rank[arcHeadList[y]])
+				{
+					swap(x, y);
+				}
+				const uint32_t arc = findArc(arcHeadList[x], arcHeadList[y]);
+
+				const float up = m->downCost[x] + m->upCost[y];
+				if (up < m->upCost[arc])
+				{
+					m->upCost[arc] = up;
+					m->upVia[arc] = VIA_NODE | *v;
+				}
+				const float down = m->downCost[y] + m->upCost[x];
+				if (down < m->downCost[arc])
+				{
+					m->downCost[arc] = down;
+					m->downVia[arc] = VIA_NODE | *v;
+				}
+			}
+		}
+	}
+
+	boost::atomic_store(&currentMetric, MetricPtr(m));
+}
+
+CustomizableHierarchy::MetricPtr CustomizableHierarchy::metric() const
+{
+	// the latest customization, which stays valid for as long as it is held
+	return boost::atomic_load(&currentMetric);
+}
+
+void CustomizableHierarchy::unpack(const Metric& m, const uint32_t arc, const bool upward, vector<edgeIndex>& edges,
+	vector<PendingArc>& pending) const
+{
+	// appends the graph edges an arc stands for, in one direction, to edges.
+	// A route through node v is the arc between v and the node it starts at,
+	// down to v, then the arc between v and the node it ends at, up from v.
+	// The arcs are expanded with a stack rather than recursion, as a deep
+	// hierarchy could overflow the call stack. The stack is the caller's, so
+	// a search can keep it from one query to the next
+
+	pending.assign(1, PendingArc(arc, upward));
+	while (!pending.empty())
+	{
+		const uint32_t a = pending.back().first;
+		const bool up = pending.back().second;
+		pending.pop_back();
+
+		const uint32_t via = up ? m.upVia[a] : m.downVia[a];
+		if (via == NO_VIA)
+		{
+			throw runtime_error("Arc has no route to unpack");
+		}
+		if ((via & VIA_NODE) == 0)
+		{
+			edges.push_back(via);
+			continue;
+		}
+
+		// the second half goes on the stack first, so it comes off second
+		const nodeIndex v = via & ~VIA_NODE;
+		const nodeIndex from = up ? arcTailList[a] : arcHeadList[a];
+		const nodeIndex to = up ? arcHeadList[a] : arcTailList[a];
+		pending.push_back(PendingArc(findArc(v, to), true));
+		pending.push_back(PendingArc(findArc(v, from), false));
+	}
+}
+
+void CustomizableHierarchy::orderNodes()
+{
+	// eliminates the nodes one at a time, always one with the fewest remaining
+	// neighbours, or the lowest index of those, and joins its neighbours to
+	// each other. What is left of a node's neighbour list when it is
+	// eliminated are its arcs. Degrees are updated lazily: a node is queued
+	// again whenever its degree changes, and entries that no longer match are
+	// skipped
+
+	const nodeIndex count = graph.nodeCount();
+	vector<vector<nodeIndex> > neighbours(count);
+	for (edgeIndex e = 0; e < graph.edgeCount(); ++e)
+	{
+		const nodeIndex tail = graph.edgeTail(e);
+		const nodeIndex head = graph.edgeHead(e);
+		if (tail != head)
+		{
+			neighbours[tail].push_back(head);
+			neighbours[head].push_back(tail);
+		}
+	}
+
+	typedef pair<size_t, nodeIndex> Entry;
+	priority_queue<Entry, vector<Entry>, greater<Entry> > queue;
+	for (nodeIndex n = 0; n < count; ++n)
+	{
+		sort(neighbours[n].begin(), neighbours[n].end());
+		neighbours[n].erase(unique(neighbours[n].begin(), neighbours[n].end()), neighbours[n].end());
+		queue.push(Entry(neighbours[n].size(), n));
+	}
+
+	rank.assign(count, INVALID_NODE);
+	byRank.clear();
+	byRank.reserve(count);
+	vector<nodeIndex> merged;
+
+	while (!queue.empty())
+	{
+		const Entry top = queue.top();
+		queue.pop();
+		const nodeIndex v = top.second;
+		if (rank[v] != INVALID_NODE || top.first != neighbours[v].size())
+		{
+			continue;
+		}
+
+		rank[v] = nodeIndex(byRank.size());
+		byRank.push_back(v);
+
+		// each neighbour loses v, and gains the others
+		const vector<nodeIndex>& clique = neighbours[v];
+		for (vector<nodeIndex>::const_iterator it = clique.cbegin(); it != clique.cend(); ++it)
+		{
+			vector<nodeIndex>& list = neighbours[*it];
+			merged.clear();
+			set_union(list.begin(), list.end(), clique.begin(), clique.end(), back_inserter(merged));
+			merged.erase(remove(merged.begin(), merged.end(), v), merged.end());
+			merged.erase(remove(merged.begin(), merged.end(), *it), merged.end());
+			list.swap(merged);
+			queue.push(Entry(list.size(), *it));
+		}
+	}
+
+	// the neighbour lists left are the arcs, in order of their heads
+	arcOffset.assign(size_t(count) + 1, 0);
+	for (nodeIndex n = 0; n < count; ++n)
+	{
+		arcOffset[n + 1] = arcOffset[n] + uint32_t(neighbours[n].size());
+		if (arcOffset[n + 1] >= DOWNWARD_EDGE)
+		{
+			throw out_of_range("Too many arcs for a customizable hierarchy");
+		}
+	}
+
+	arcTailList.resize(arcOffset[count]);
+	arcHeadList.resize(arcOffset[count]);
+	for (nodeIndex n = 0; n < count; ++n)
+	{
+		fill(arcTailList.begin() + arcOffset[n], arcTailList.begin() + arcOffset[n + 1], n);
+		copy(neighbours[n].begin(), neighbours[n].end(), arcHeadList.begin() + arcOffset[n]);
+		vector<nodeIndex>().swap(neighbours[n]);
+	}
+}
+
+void CustomizableHierarchy::mapEdges()
+{
+	// finds the arc every edge belongs to, and which way along it the edge runs
+
+	edgeArc.resize(graph.edgeCount());
+	for (edgeIndex e = 0; e < graph.edgeCount(); ++e)
+	{
+		const nodeIndex tail = graph.edgeTail(e);
+		const nodeIndex head = graph.edgeHead(e);
+		if (tail == head)
+		{
+			edgeArc[e] = NO_VIA;
+		}
+		else if (rank[tail] < rank[head])
+		{
+			edgeArc[e] = findArc(tail, head);
+		}
+		else
+		{
+			edgeArc[e] = findArc(head, tail) | DOWNWARD_EDGE;
+		}
+	}
+}
+
+uint32_t CustomizableHierarchy::findArc(const nodeIndex lower, const nodeIndex higher) const
+{
+	// the arc from the lower node to the higher one, which the elimination
+	// guarantees is there
+	const vector<nodeIndex>::const_iterator first = arcHeadList.begin() + arcOffset[lower];
+	const vector<nodeIndex>::const_iterator last = arcHeadList.begin() + arcOffset[lower + 1];
+	return uint32_t(lower_bound(first, last, higher) - arcHeadList.begin());
+}
@@ -0,0 +1,118 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * CustomizableHierarchy.h
+ */
+
+#ifndef CUSTOMIZABLE_HIERARCHY_H
+#define CUSTOMIZABLE_HIERARCHY_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "GraphTypes.h"
+#include "Graph.h"
+
+using std::vector;
+
+
+// ---------------------------------------------------------------------------------/
+// The CustomizableHierarchy class preprocesses a Graph for fast shortest route		/
+// queries, like ContractionHierarchy, but in two phases, so that new edge costs	/
+// can be taken in quickly, see CustomizableHierarchySearch.						/
+//																					/
+// The first phase only looks at which nodes are joined, not at the costs. The		/
+// nodes are put in order by eliminating them one at a time from the undirected		/
+// graph, always one with the fewest remaining neighbours, and joining those		/
+// neighbours to each other. Each node gets an arc to every neighbour it had		/
+// when it was eliminated, all of which come later in the order. This is slow		/
+// but only needs doing once for a graph.											/
+//																					/
+// The second phase, customize(), works out the costs of the arcs for the			/
+// Graph's current edge costs, in a single pass over the arcs: an arc starts		/
+// with the cost of the cheapest edge between its two nodes in each direction,		/
+// and then, taking the nodes in order, every route x->v->y through a node v		/
+// is tried against the arc between x and y. Its result, a Metric, replaces the		/
+// current one in one step, as Graph::updateEdgeCosts() does with the costs, so		/
+// a search keeps the Metric it started with.										/
+//																					/
+// An arc joins its lower node, the one earlier in the order, to its higher			/
+// node. It has a cost each way, up from the lower node and down from the			/
+// higher one, either of which is infinite if there is no route that way.			/
+// ---------------------------------------------------------------------------------/
+
+class CustomizableHierarchy
+{
+public:
+
+	// the arc costs for one set of edge costs. An arc's via in each direction
+	// is the graph edge it stands for, or VIA_NODE plus the node its route
+	// goes through, or NO_VIA if it has no route that way
+	struct Metric
+	{
+		vector<float> upCost;
+		vector<float> downCost;
+		vector<std::uint32_t> upVia;
+		vector<std::uint32_t> downVia;
+		Graph::CostTable edgeCosts;
+	};
+
+	typedef boost::shared_ptr<const Metric> MetricPtr;
+
+	// an arc still to be unpacked, and whether it is taken upwards
+	typedef std::pair<std::uint32_t, bool> PendingArc;
+
+	static constexpr std::uint32_t VIA_NODE = 0x80000000u;
+	static constexpr std::uint32_t NO_VIA = 0xFFFFFFFFu;
+
+	// Constructor, which orders the nodes and customizes the arcs for the
+	// graph's current costs
+	//
+
+	explicit CustomizableHierarchy(const Graph&);
+
+	// public utility functions
+	//
+
+	nodeIndex nodeCount() const;
+	std::uint32_t arcCount() const;
+	nodeIndex rankOf(const nodeIndex) const;
+	void customize();
+	MetricPtr metric() const;
+	void unpack(const Metric&, const std::uint32_t, const bool, vector<edgeIndex>&, vector<PendingArc>&) const;
+
+	// The arcs are scanned on every step of a query,
+	// so the accessors are inlined.
+	// The arcs of node n lead to higher nodes, and are scanned upwards from
+	// the initial node, and backwards from the goal
+
+	std::uint32_t arcsBegin(const nodeIndex n) const { return arcOffset[n]; }
+	std::uint32_t arcsEnd(const nodeIndex n) const { return arcOffset[n + 1]; }
+	nodeIndex arcHead(const std::uint32_t i) const { return arcHeadList[i]; }
+
+private:
+	const Graph& graph;
+	vector<nodeIndex> rank;
+	vector<nodeIndex> byRank;
+
+	// the arcs, by their lower node, and in order of their higher node within it
+	vector<std::uint32_t> arcOffset;
+	vector<nodeIndex> arcTailList;
+	vector<nodeIndex> arcHeadList;
+
+	// the arc of each graph edge, plus DOWNWARD_EDGE if the edge runs from
+	// the higher node to the lower one, or NO_VIA for a loop
+	vector<std::uint32_t> edgeArc;
+
+	MetricPtr currentMetric;
+
+	// private utility functions
+	//
+
+	void orderNodes();
+	void mapEdges();
+	std::uint32_t findArc(const nodeIndex, const nodeIndex) const;
+};
+
+#endif /* CUSTOMIZABLE_HIERARCHY_H */
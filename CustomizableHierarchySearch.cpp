@@ -0,0 +1,225 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * CustomizableHierarchySearch.cpp
+ */
+
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include "CustomizableHierarchySearch.h"
+
+CustomizableHierarchySearch::CustomizableHierarchySearch(const Graph& g, const CustomizableHierarchy& h, const Frontier::Type frontierType)
+	: SearchBase(g), hierarchy(h), frontier(frontierType), backwardFrontier(frontierType),
+	bestCost(0.0f), meetingNode(INVALID_NODE)
+{
+	// empty constructor
+}
+
+void CustomizableHierarchySearch::start()
+{
+	// check that the hierarchy was built for this graph before touching it
+	if (hierarchy.nodeCount() != graph.nodeCount())
+	{
+		throw runtime_error("Customizable hierarchy does not match the graph");
+	}
+
+	// the route is costed with the edge costs of the metric searched, which
+	// may be older than the graph's
+	metric = hierarchy.metric();
+	costSnapshot = metric->edgeCosts;
+	costData = costSnapshot->data();
+
+	context.prepare(graph.nodeCount());
+	frontier.prepare(graph.nodeCount());
+	backward.prepare(graph.nodeCount());
+	backwardFrontier.prepare(graph.nodeCount());
+
+	// put the initial node in the forward frontier, and the goal node in the
+	// backward frontier, each with cost:0 and status:frontier
+	context.stateAt(initialNode).setStatus(NodeState::FRONTIER);
+	context.stateAt(initialNode).setPathCost(0.0f);
+	frontier.push(initialNode, 0.0f);
+
+	backward.stateAt(goalNode).setStatus(NodeState::FRONTIER);
+	backward.stateAt(goalNode).setPathCost(0.0f);
+	backwardFrontier.push(goalNode, 0.0f);
+
+	bestCost = numeric_limits<float>::infinity();
+	meetingNode = INVALID_NODE;
+}
+
+void CustomizableHierarchySearch::collectStats()
+{
+	stats.addFrontier(frontier);
+	stats.addFrontier(backwardFrontier);
+}
+
+void CustomizableHierarchySearch::finish()
+{
+	// clear the search state of both sides, so we can search again, and let
+	// go of the metric
+	SearchBase::finish();
+	backward.clear();
+	metric.reset();
+}
+
+SearchStatus CustomizableHierarchySearch::processNext()
+{
+	// a side is finished once its frontier is empty, or its smallest key is
+	// no less than the best route found so far
+	const bool forwardOpen = !frontier.empty() && frontier.topKey() < bestCost;
+	const bool backwardOpen = !backwardFrontier.empty() && backwardFrontier.topKey() < bestCost;
+
+	if (!forwardOpen && !backwardOpen)
+	{
+		// empty the frontiers so they are ready for the next search
+		frontier.clear();
+		backwardFrontier.clear();
+
+		if (meetingNode == INVALID_NODE)
+		{
+			return SearchStatus::FAILURE;
+		}
+		unpackPath();
+		return SearchStatus::SUCCESS;
+	}
+
+	// otherwise expand the open side with the smaller key
+	if (forwardOpen && (!backwardOpen || frontier.topKey() <= backwardFrontier.topKey()))
+	{
+		expandForward();
+	}
+	else
+	{
+		expandBackward();
+	}
+
+	// Return that we are still searching
+	return SearchStatus::SEARCHING;
+}
+
+void CustomizableHierarchySearch::expandForward()
+{
+	// take a node from the forward frontier, and set to explored
+	nodeIndex currentNode = frontier.pop();
+	NodeState& current = context.stateAt(currentNode);
+	current.setStatus(NodeState::EXPLORED);
+
+	// if the backward side has reached the node, there is a route through it
+	const SearchContext& other = backward;
+	const NodeState& meeting = other.stateAt(currentNode);
+	if (meeting.getStatus() != NodeState::UNEXPLORED && current.getPathCost() + meeting.getPathCost() < bestCost)
+	{
+		bestCost = current.getPathCost() + meeting.getPathCost();
+		meetingNode = currentNode;
+	}
+
+	// the action of a node is the arc it was reached by. An arc with no route
+	// upwards has an infinite cost, and is passed over
+	const vector<float>& costs = metric->upCost;
+	stats.edgesRelaxed += hierarchy.arcsEnd(currentNode) - hierarchy.arcsBegin(currentNode);
+	for( uint32_t i = hierarchy.arcsBegin(currentNode); i != hierarchy.arcsEnd(currentNode); ++i)
+	{
+		if (costs[i] == numeric_limits<float>::infinity())
+		{
+			continue;
+		}
+
+		const nodeIndex childNode = hierarchy.arcHead(i);
+		NodeState& child = context.stateAt(childNode);
+		float newNodeCost = current.getPathCost() + costs[i];
+
+		if (child.getStatus() == NodeState::UNEXPLORED)
+		{
+			child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, i);
+			frontier.push(childNode, newNodeCost);
+		}
+		else if (child.getStatus() == NodeState::FRONTIER && newNodeCost < child.getPathCost())
+		{
+			child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, i);
+			frontier.decreaseKey(childNode, newNodeCost);
+		}
+	}
+}
+
+void CustomizableHierarchySearch::expandBackward()
+{
+	// take a node from the backward frontier, and set to explored.
+	// The parent of a node on this side is the next node towards the goal
+	nodeIndex currentNode = backwardFrontier.pop();
+	NodeState& current = backward.stateAt(currentNode);
+	current.setStatus(NodeState::EXPLORED);
+
+	// if the forward side has reached the node, there is a route through it
+	const SearchContext& other = context;
+	const NodeState& meeting = other.stateAt(currentNode);
+	if (meeting.getStatus() != NodeState::UNEXPLORED && meeting.getPathCost() + current.getPathCost() < bestCost)
+	{
+		bestCost = meeting.getPathCost() + current.getPathCost();
+		meetingNode = currentNode;
+	}
+
+	// this side follows the arcs down from their higher nodes, backwards
+	const vector<float>& costs = metric->downCost;
+	stats.edgesRelaxed += hierarchy.arcsEnd(currentNode) - hierarchy.arcsBegin(currentNode);
+	for( uint32_t i = hierarchy.arcsBegin(currentNode); i != hierarchy.arcsEnd(currentNode); ++i)
+	{
+		if (costs[i] == numeric_limits<float>::infinity())
+		{
+			continue;
+		}
+
+		const nodeIndex childNode = hierarchy.arcHead(i);
+		NodeState& child = backward.stateAt(childNode);
+		float newNodeCost = current.getPathCost() + costs[i];
+
+		if (child.getStatus() == NodeState::UNEXPLORED)
+		{
+			child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, i);
+			backwardFrontier.push(childNode, newNodeCost);
+		}
+		else if (child.getStatus() == NodeState::FRONTIER && newNodeCost < child.getPathCost())
+		{
+			child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, i);
+			backwardFrontier.decreaseKey(childNode, newNodeCost);
+		}
+	}
+}
+
+void CustomizableHierarchySearch::unpackPath()
+{
+	// unpacks the arcs of the route, upwards from the initial node to the
+	// meeting node, and downwards from there to the goal, into the graph's
+	// edges. The edges are then recorded in the forward states, with costs
+	// summed from the initial node as the unidirectional searches do, so the
+	// route can be traced back along the parents from the goal
+
+	const SearchContext& forwardStates = context;
+	const SearchContext& backwardStates = backward;
+	upArcs.clear();
+
+	for (nodeIndex n = meetingNode; n != initialNode; n = forwardStates.stateAt(n).getParentNode())
+	{
+		upArcs.push_back(forwardStates.stateAt(n).getParentAction());
+	}
+
+	routeEdges.clear();
+	for (vector<uint32_t>::const_reverse_iterator it = upArcs.crbegin(); it != upArcs.crend(); ++it)
+	{
+		hierarchy.unpack(*metric, *it, true, routeEdges, pendingArcs);
+	}
+	for (nodeIndex n = meetingNode; n != goalNode; n = backwardStates.stateAt(n).getParentNode())
+	{
+		hierarchy.unpack(*metric, backwardStates.stateAt(n).getParentAction(), false, routeEdges, pendingArcs);
+	}
+
+	nodeIndex currentNode = initialNode;
+	for (vector<edgeIndex>::const_iterator it = routeEdges.cbegin(); it != routeEdges.cend(); ++it)
+	{
+		nodeIndex nextNode = graph.edgeHead(*it);
+		float cost = context.stateAt(currentNode).getPathCost() + edgeCost(*it);
+		context.stateAt(nextNode).setSearchState(NodeState::EXPLORED, cost, currentNode, *it);
+		currentNode = nextNode;
+	}
+}
@@ -0,0 +1,76 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * CustomizableHierarchySearch.h
+ */
+
+#ifndef CUSTOMIZABLE_HIERARCHY_SEARCH_H
+#define CUSTOMIZABLE_HIERARCHY_SEARCH_H
+
+#include "SearchBase.h"
+#include "Frontier.h"
+#include "CustomizableHierarchy.h"
+
+
+using namespace std;
+
+// ---------------------------------------------------------------------------------/
+// The CustomizableHierarchySearch class answers queries on a						/
+// CustomizableHierarchy, in the same way as ContractionHierarchySearch: it			/
+// searches upwards from the initial node with the arcs' upward costs, and			/
+// upwards from the goal with their downward costs, until neither side can			/
+// improve on the best route through a node both have reached.						/
+//																					/
+// The search takes the hierarchy's current Metric when it starts, and keeps it		/
+// to the end, so a customization part way through does not affect it. The route	/
+// found is unpacked into the graph's edges, and costed with the edge costs the		/
+// Metric was customized for.														/
+// ---------------------------------------------------------------------------------/
+
+class CustomizableHierarchySearch : public SearchBase
+{
+public:
+
+	// Constructor
+	//
+
+	CustomizableHierarchySearch(const Graph&, const CustomizableHierarchy&, const Frontier::Type = Frontier::D_ARY_HEAP);
+
+	// public utility functions
+	//
+
+	virtual SearchStatus processNext();
+
+protected:
+	virtual void start();
+	virtual void collectStats();
+	virtual void finish();
+
+private:
+	const CustomizableHierarchy& hierarchy;
+	CustomizableHierarchy::MetricPtr metric;
+
+	// the forward side uses SearchBase's context
+	Frontier frontier;
+	SearchContext backward;
+	Frontier backwardFrontier;
+
+	// the shortest route found so far, and the node where its two halves meet
+	float bestCost;
+	nodeIndex meetingNode;
+
+	// the upward arcs and the edges of the route being unpacked, and the stack
+	// of arcs still to unpack, kept so a query does not allocate them
+	vector<std::uint32_t> upArcs;
+	vector<edgeIndex> routeEdges;
+	vector<CustomizableHierarchy::PendingArc> pendingArcs;
+
+	// private utility functions
+	//
+
+	void expandForward();
+	void expandBackward();
+	void unpackPath();
+};
+
+#endif /* CUSTOMIZABLE_HIERARCHY_SEARCH_H */
@@ -0,0 +1,204 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * DistanceKernel.cpp
+ */
+
+#include <cmath>
+#include <algorithm>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "DistanceKernel.h"
+
+using namespace std;
+
+static const double TO_RAD = 0.01745329251994329;
+static const float EARTH_RADIUS = 6371.0f;
+
+// the polynomial coefficients of the bounded mode. The sine and cosine series
+// are cut off after a negative term, and the arcsine series is all positive,
+// so each stays below the function it replaces over the range it is used on
+static const float HALF_TO_RAD = 0.00872664626f;
+static const float DEG_TO_RAD = 0.01745329252f;
+static const float SIN3 = -1.0f / 6.0f;
+static const float SIN5 = 1.0f / 120.0f;
+static const float SIN7 = -1.0f / 5040.0f;
+static const float COS2 = -1.0f / 2.0f;
+static const float COS4 = 1.0f / 24.0f;
+static const float COS6 = -1.0f / 720.0f;
+static const float ASIN3 = 1.0f / 6.0f;
+static const float ASIN5 = 3.0f / 40.0f;
+
+// the bounded distance is scaled down by this much, which is far more than the
+// rounding error of the float arithmetic, so it stays a lower bound
+static const float BOUND_SCALE = 2.0f * EARTH_RADIUS * (1.0f - 1.0e-5f);
+
+DistanceKernel::DistanceKernel(const Graph& g, const Mode m) : graph(g), mode(m),
+	targetLatitude(0.0f), targetLongitude(0.0f), targetCos(1.0), targetCosF(1.0f)
+{
+	// empty constructor
+}
+
+void DistanceKernel::setTarget(const nodeIndex target)
+{
+	// works out the terms of the target once per query
+
+	targetLatitude = graph.nodeLatitude(target);
+	targetLongitude = graph.nodeLongitude(target);
+	targetCos = cos(TO_RAD * targetLatitude);
+	targetCosF = float(targetCos);
+}
+
+float DistanceKernel::distance(const nodeIndex n) const
+{
+	const float latitude = graph.nodeLatitude(n);
+	const float longitude = graph.nodeLongitude(n);
+	return (mode == HAVERSINE) ? haversine(latitude, longitude) : bounded(latitude, longitude);
+}
+
+void DistanceKernel::fill(const nodeIndex* nodes, const size_t count, float* distances) const
+{
+	if (mode == BOUNDED)
+	{
+		fillBounded(nodes, count, distances);
+		return;
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		distances[i] = haversine(graph.nodeLatitude(nodes[i]), graph.nodeLongitude(nodes[i]));
+	}
+}
+
+float DistanceKernel::haversine(const float latitude, const float longitude) const
+{
+	// Node::linearDistanceTo(), from the node to the target, with the cosine
+	// of the target's latitude taken from setTarget(). The operations are the
+	// same and in the same order, so the result is the same to the last bit
+
+	double dLat = (latitude - targetLatitude)*TO_RAD;
+	double dLon = (longitude - targetLongitude)*TO_RAD;
+	double a = sin(dLat/2.0) * sin(dLat/2.0) +
+		sin(dLon/2.0) * sin(dLon/2.0) * targetCos * cos(TO_RAD*latitude);
+	double c = 2.0 * atan2(sqrt(a), sqrt(1-a));
+	return float(EARTH_RADIUS * c);
+}
+
+float DistanceKernel::bounded(const float latitude, const float longitude) const
+{
+	// the haversine formula with polynomial lower bounds in place of the
+	// trigonometric functions. Half the differences in latitude and longitude
+	// (the longitude taken the short way round) are in [0, pi/2], where the
+	// sine series bound holds, and the cosine bound is clamped at zero
+
+	const float x1 = fabs(latitude - targetLatitude) * HALF_TO_RAD;
+	const float dl = fabs(longitude - targetLongitude);
+	const float x2 = min(dl, 360.0f - dl) * HALF_TO_RAD;
+	const float lat = latitude * DEG_TO_RAD;
+
+	const float x1s = x1 * x1;
+	const float x2s = x2 * x2;
+	const float lats = lat * lat;
+	const float s1 = x1 * (1.0f + x1s * (SIN3 + x1s * (SIN5 + x1s * SIN7)));
+	const float s2 = x2 * (1.0f + x2s * (SIN3 + x2s * (SIN5 + x2s * SIN7)));
+	const float c = max(0.0f, 1.0f + lats * (COS2 + lats * (COS4 + lats * COS6)));
+
+	const float a = s1 * s1 + s2 * s2 * c * targetCosF;
+	const float y = sqrt(min(a, 1.0f));
+	const float ys = y * y;
+	return BOUND_SCALE * (y * (1.0f + ys * (ASIN3 + ys * ASIN5)));
+}
+
+void DistanceKernel::fillBounded(const nodeIndex* nodes, const size_t count, float* distances) const
+{
+	// the same steps as bounded(), on a vector of nodes at a time. The
+	// absolute value clears the sign bit, and the remaining nodes are done
+	// one at a time
+
+	const float* latitudes = graph.latitudeArray().data();
+	const float* longitudes = graph.longitudeArray().data();
+	size_t i = 0;
+
+#if defined(__AVX2__)
+	// gathers take signed 32 bit indices
+	if (graph.nodeCount() <= 0x7FFFFFFFu)
+	{
+		const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 tLat = _mm256_set1_ps(targetLatitude);
+		const __m256 tLon = _mm256_set1_ps(targetLongitude);
+		const __m256 tCos = _mm256_set1_ps(targetCosF);
+
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(nodes + i));
+			const __m256 latitude = _mm256_i32gather_ps(latitudes, index, 4);
+			const __m256 longitude = _mm256_i32gather_ps(longitudes, index, 4);
+
+			const __m256 x1 = _mm256_mul_ps(_mm256_and_ps(_mm256_sub_ps(latitude, tLat), signMask), _mm256_set1_ps(HALF_TO_RAD));
+			const __m256 dl = _mm256_and_ps(_mm256_sub_ps(longitude, tLon), signMask);
+			const __m256 x2 = _mm256_mul_ps(_mm256_min_ps(dl, _mm256_sub_ps(_mm256_set1_ps(360.0f), dl)), _mm256_set1_ps(HALF_TO_RAD));
+			const __m256 lat = _mm256_mul_ps(latitude, _mm256_set1_ps(DEG_TO_RAD));
+
+			const __m256 x1s = _mm256_mul_ps(x1, x1);
+			const __m256 x2s = _mm256_mul_ps(x2, x2);
+			const __m256 lats = _mm256_mul_ps(lat, lat);
+			const __m256 s1 = _mm256_mul_ps(x1, _mm256_add_ps(one, _mm256_mul_ps(x1s, _mm256_add_ps(_mm256_set1_ps(SIN3),
+				_mm256_mul_ps(x1s, _mm256_add_ps(_mm256_set1_ps(SIN5), _mm256_mul_ps(x1s, _mm256_set1_ps(SIN7))))))));
+			const __m256 s2 = _mm256_mul_ps(x2, _mm256_add_ps(one, _mm256_mul_ps(x2s, _mm256_add_ps(_mm256_set1_ps(SIN3),
+				_mm256_mul_ps(x2s, _mm256_add_ps(_mm256_set1_ps(SIN5), _mm256_mul_ps(x2s, _mm256_set1_ps(SIN7))))))));
+			const __m256 c = _mm256_max_ps(_mm256_setzero_ps(), _mm256_add_ps(one, _mm256_mul_ps(lats, _mm256_add_ps(_mm256_set1_ps(COS2),
+				_mm256_mul_ps(lats, _mm256_add_ps(_mm256_set1_ps(COS4), _mm256_mul_ps(lats, _mm256_set1_ps(COS6))))))));
+
+			const __m256 a = _mm256_add_ps(_mm256_mul_ps(s1, s1), _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(s2, s2), c), tCos));
+			const __m256 y = _mm256_sqrt_ps(_mm256_min_ps(a, one));
+			const __m256 ys = _mm256_mul_ps(y, y);
+			const __m256 arc = _mm256_mul_ps(y, _mm256_add_ps(one, _mm256_mul_ps(ys, _mm256_add_ps(_mm256_set1_ps(ASIN3), _mm256_mul_ps(ys, _mm256_set1_ps(ASIN5))))));
+			_mm256_storeu_ps(distances + i, _mm256_mul_ps(_mm256_set1_ps(BOUND_SCALE), arc));
+		}
+	}
+#elif defined(__SSE2__)
+	{
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 tLat = _mm_set1_ps(targetLatitude);
+		const __m128 tLon = _mm_set1_ps(targetLongitude);
+		const __m128 tCos = _mm_set1_ps(targetCosF);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 latitude = _mm_set_ps(latitudes[nodes[i + 3]], latitudes[nodes[i + 2]], latitudes[nodes[i + 1]], latitudes[nodes[i]]);
+			const __m128 longitude = _mm_set_ps(longitudes[nodes[i + 3]], longitudes[nodes[i + 2]], longitudes[nodes[i + 1]], longitudes[nodes[i]]);
+
+			const __m128 x1 = _mm_mul_ps(_mm_and_ps(_mm_sub_ps(latitude, tLat), signMask), _mm_set1_ps(HALF_TO_RAD));
+			const __m128 dl = _mm_and_ps(_mm_sub_ps(longitude, tLon), signMask);
+			const __m128 x2 = _mm_mul_ps(_mm_min_ps(dl, _mm_sub_ps(_mm_set1_ps(360.0f), dl)), _mm_set1_ps(HALF_TO_RAD));
+			const __m128 lat = _mm_mul_ps(latitude, _mm_set1_ps(DEG_TO_RAD));
+
+			const __m128 x1s = _mm_mul_ps(x1, x1);
+			const __m128 x2s = _mm_mul_ps(x2, x2);
+			const __m128 lats = _mm_mul_ps(lat, lat);
+			const __m128 s1 = _mm_mul_ps(x1, _mm_add_ps(one, _mm_mul_ps(x1s, _mm_add_ps(_mm_set1_ps(SIN3),
+				_mm_mul_ps(x1s, _mm_add_ps(_mm_set1_ps(SIN5), _mm_mul_ps(x1s, _mm_set1_ps(SIN7))))))));
+			const __m128 s2 = _mm_mul_ps(x2, _mm_add_ps(one, _mm_mul_ps(x2s, _mm_add_ps(_mm_set1_ps(SIN3),
+				_mm_mul_ps(x2s, _mm_add_ps(_mm_set1_ps(SIN5), _mm_mul_ps(x2s, _mm_set1_ps(SIN7))))))));
+			const __m128 c = _mm_max_ps(_mm_setzero_ps(), _mm_add_ps(one, _mm_mul_ps(lats, _mm_add_ps(_mm_set1_ps(COS2),
+				_mm_mul_ps(lats, _mm_add_ps(_mm_set1_ps(COS4), _mm_mul_ps(lats, _mm_set1_ps(COS6))))))));
+
+			const __m128 a = _mm_add_ps(_mm_mul_ps(s1, s1), _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(s2, s2), c), tCos));
+			const __m128 y = _mm_sqrt_ps(_mm_min_ps(a, one));
+			const __m128 ys = _mm_mul_ps(y, y);
+			const __m128 arc = _mm_mul_ps(y, _mm_add_ps(one, _mm_mul_ps(ys, _mm_add_ps(_mm_set1_ps(ASIN3), _mm_mul_ps(ys, _mm_set1_ps(ASIN5))))));
+			_mm_storeu_ps(distances + i, _mm_mul_ps(_mm_set1_ps(BOUND_SCALE), arc));
+		}
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		distances[i] = bounded(latitudes[nodes[i]], longitudes[nodes[i]]);
+	}
+}
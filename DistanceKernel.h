@@ -0,0 +1,80 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * DistanceKernel.h
+ */
+
+#ifndef DISTANCE_KERNEL_H
+#define DISTANCE_KERNEL_H
+
+#include <cstddef>
+#include "GraphTypes.h"
+#include "Graph.h"
+
+
+// ---------------------------------------------------------------------------------/
+// The DistanceKernel class computes the straight line (great circle) distance		/
+// in km from nodes of a Graph to one fixed target node, for the heuristics of		/
+// the map searches. The terms that only depend on the target are worked out		/
+// once by setTarget(), at the start of a query, rather than on every call, and		/
+// the node coordinates are read straight from the Graph's latitude and				/
+// longitude arrays. fill() computes the distances of a block of nodes at once,		/
+// such as the heads of the edges leaving a node.									/
+//																					/
+//		HAVERSINE	:	the haversine formula, in double precision, exactly as		/
+//						Node::linearDistanceTo() computes it, so a search gives		/
+//						the same result with either.								/
+//		BOUNDED		:	a cheaper lower bound on the same distance, with no			/
+//						trigonometric calls per node: every sine, cosine and		/
+//						arcsine is replaced by a short polynomial that is never		/
+//						more than it, and the result is scaled down to cover		/
+//						float rounding. Away from the poles, it is within a			/
+//						tenth of a percent for distances up to a few thousand		/
+//						km, and it is admissible wherever the haversine				/
+//						distance is.												/
+//																					/
+// In BOUNDED mode fill() works on several nodes per instruction, with AVX2 when	/
+// the compiler targets it (-mavx2), SSE2 otherwise, or one at a time when			/
+// neither is available.															/
+// ---------------------------------------------------------------------------------/
+
+class DistanceKernel
+{
+public:
+
+	// Enum for the distance computed
+	//
+	enum Mode { HAVERSINE, BOUNDED };
+
+	// Constructor
+	//
+
+	explicit DistanceKernel(const Graph&, const Mode = HAVERSINE);
+
+	// public utility functions
+	//
+
+	void setTarget(const nodeIndex);
+	float distance(const nodeIndex) const;
+	void fill(const nodeIndex*, const std::size_t, float*) const;
+	Mode getMode() const { return mode; }
+
+private:
+	const Graph& graph;
+	Mode mode;
+
+	// the target, and its terms for each mode
+	float targetLatitude;
+	float targetLongitude;
+	double targetCos;
+	float targetCosF;
+
+	// private utility functions
+	//
+
+	float haversine(const float, const float) const;
+	float bounded(const float, const float) const;
+	void fillBounded(const nodeIndex*, const std::size_t, float*) const;
+};
+
+#endif /* DISTANCE_KERNEL_H */
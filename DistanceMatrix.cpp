@@ -0,0 +1,238 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * DistanceMatrix.cpp
+ */
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include "DistanceMatrix.h"
+
+using namespace std;
+
+static const float UNREACHABLE = numeric_limits<float>::infinity();
+
+DistanceMatrix::DistanceMatrix(const Graph& g) : graph(g), hierarchy(0)
+{
+	// empty constructor
+}
+
+DistanceMatrix::DistanceMatrix(const Graph& g, const ContractionHierarchy& h) : graph(g), hierarchy(&h)
+{
+	// empty constructor
+}
+
+void DistanceMatrix::compute(const vector<nodeIndex>& sources, const vector<nodeIndex>& targets, vector<float>& costs)
+{
+	// check that every node exists before touching any search state
+	for (vector<nodeIndex>::const_iterator it = sources.cbegin(); it != sources.cend(); ++it)
+	{
+		if (*it >= graph.nodeCount())
+		{
+			throw out_of_range("Node index out of range");
+		}
+	}
+	for (vector<nodeIndex>::const_iterator it = targets.cbegin(); it != targets.cend(); ++it)
+	{
+		if (*it >= graph.nodeCount())
+		{
+			throw out_of_range("Node index out of range");
+		}
+	}
+	if (hierarchy && hierarchy->nodeCount() != graph.nodeCount())
+	{
+		throw runtime_error("Contraction hierarchy does not match the graph");
+	}
+
+	costs.assign(sources.size() * targets.size(), UNREACHABLE);
+	if (costs.empty())
+	{
+		return;
+	}
+
+	context.prepare(graph.nodeCount());
+	frontier.prepare(graph.nodeCount());
+
+	if (hierarchy)
+	{
+		computeWithBuckets(sources, targets, costs);
+	}
+	else
+	{
+		// the edge costs as they are now, held until every row is done
+		const Graph::CostTable edgeCosts = graph.costTable();
+		computeWithTrees(sources, targets, edgeCosts->data(), costs);
+	}
+}
+
+void DistanceMatrix::computeWithTrees(const vector<nodeIndex>& sources, const vector<nodeIndex>& targets, const float* edgeCosts,
+	vector<float>& costs)
+{
+	// one search per source, each read off for the whole row
+
+	isTarget.assign(graph.nodeCount(), 0);
+	unsigned distinctTargets = 0;
+	for (vector<nodeIndex>::const_iterator it = targets.cbegin(); it != targets.cend(); ++it)
+	{
+		if (!isTarget[*it])
+		{
+			isTarget[*it] = 1;
+			++distinctTargets;
+		}
+	}
+
+	const SearchContext& states = context;
+	for (size_t row = 0; row < sources.size(); ++row)
+	{
+		searchGraph(sources[row], edgeCosts, distinctTargets);
+
+		float* rowCosts = &costs[row * targets.size()];
+		for (size_t column = 0; column < targets.size(); ++column)
+		{
+			const NodeState& target = states.stateAt(targets[column]);
+			if (target.getStatus() == NodeState::EXPLORED)
+			{
+				rowCosts[column] = target.getPathCost();
+			}
+		}
+		context.clear();
+	}
+}
+
+void DistanceMatrix::computeWithBuckets(const vector<nodeIndex>& sources, const vector<nodeIndex>& targets, vector<float>& costs)
+{
+	// the backward searches first, from every target, collecting the bucket
+	// entries of every node they settle, then sorted into CSR form by node
+
+	vector<nodeIndex> entryNode;
+	vector<BucketEntry> entries;
+	for (size_t column = 0; column < targets.size(); ++column)
+	{
+		searchUpwards(targets[column], true);
+		for (vector<Settled>::const_iterator it = settled.cbegin(); it != settled.cend(); ++it)
+		{
+			BucketEntry entry = { uint32_t(column), it->cost };
+			entryNode.push_back(it->node);
+			entries.push_back(entry);
+		}
+	}
+
+	bucketOffset.assign(size_t(graph.nodeCount()) + 1, 0);
+	for (vector<nodeIndex>::const_iterator it = entryNode.cbegin(); it != entryNode.cend(); ++it)
+	{
+		++bucketOffset[*it + 1];
+	}
+	for (nodeIndex n = 0; n < graph.nodeCount(); ++n)
+	{
+		bucketOffset[n + 1] += bucketOffset[n];
+	}
+	bucketList.resize(entries.size());
+	vector<uint32_t> next(bucketOffset.begin(), bucketOffset.end() - 1);
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		bucketList[next[entryNode[i]]++] = entries[i];
+	}
+
+	// then the forward searches, from every source. A route from the source to
+	// a target meets at the highest node on it, which both searches settle, so
+	// the smallest sum over the buckets is the cost of the shortest route
+	for (size_t row = 0; row < sources.size(); ++row)
+	{
+		searchUpwards(sources[row], false);
+
+		float* rowCosts = &costs[row * targets.size()];
+		for (vector<Settled>::const_iterator it = settled.cbegin(); it != settled.cend(); ++it)
+		{
+			for (uint32_t i = bucketOffset[it->node]; i != bucketOffset[it->node + 1]; ++i)
+			{
+				const BucketEntry& entry = bucketList[i];
+				rowCosts[entry.column] = min(rowCosts[entry.column], it->cost + entry.cost);
+			}
+		}
+	}
+}
+
+void DistanceMatrix::searchGraph(const nodeIndex source, const float* edgeCosts, unsigned remainingTargets)
+{
+	// uniform cost search from the source, until every target is settled or
+	// there is nothing left to reach. The costs are left in the context
+
+	context.stateAt(source).setSearchState(NodeState::FRONTIER, 0.0f, INVALID_NODE, INVALID_EDGE);
+	frontier.push(source, 0.0f);
+
+	while (!frontier.empty() && remainingTargets > 0)
+	{
+		nodeIndex currentNode = frontier.pop();
+		NodeState& current = context.stateAt(currentNode);
+		current.setStatus(NodeState::EXPLORED);
+		if (isTarget[currentNode])
+		{
+			--remainingTargets;
+		}
+
+		for( edgeIndex edge = graph.edgesBegin(currentNode); edge != graph.edgesEnd(currentNode); ++edge)
+		{
+			nodeIndex childNode = graph.edgeHead(edge);
+			NodeState& child = context.stateAt(childNode);
+			float newNodeCost = current.getPathCost() + edgeCosts[edge];
+
+			if (child.getStatus() == NodeState::UNEXPLORED)
+			{
+				child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, edge);
+				frontier.push(childNode, newNodeCost);
+			}
+			else if (child.getStatus() == NodeState::FRONTIER && newNodeCost < child.getPathCost())
+			{
+				child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, edge);
+				frontier.decreaseKey(childNode, newNodeCost);
+			}
+		}
+	}
+
+	// empty the frontier so it is ready for the next search
+	frontier.clear();
+}
+
+void DistanceMatrix::searchUpwards(const nodeIndex start, const bool down)
+{
+	// the whole upward search space of the start node, over the upward arcs, or
+	// over the downward arcs backwards for a target. Every settled node is
+	// listed with its cost, and the context is cleared again
+
+	settled.clear();
+	context.stateAt(start).setSearchState(NodeState::FRONTIER, 0.0f, INVALID_NODE, INVALID_EDGE);
+	frontier.push(start, 0.0f);
+
+	while (!frontier.empty())
+	{
+		nodeIndex currentNode = frontier.pop();
+		NodeState& current = context.stateAt(currentNode);
+		current.setStatus(NodeState::EXPLORED);
+
+		Settled node = { currentNode, current.getPathCost() };
+		settled.push_back(node);
+
+		const uint32_t begin = down ? hierarchy->downBegin(currentNode) : hierarchy->upBegin(currentNode);
+		const uint32_t end = down ? hierarchy->downEnd(currentNode) : hierarchy->upEnd(currentNode);
+		for (uint32_t i = begin; i != end; ++i)
+		{
+			const ContractionHierarchy::SearchArc& arc = down ? hierarchy->downArc(i) : hierarchy->upArc(i);
+			NodeState& child = context.stateAt(arc.node);
+			float newNodeCost = current.getPathCost() + arc.cost;
+
+			if (child.getStatus() == NodeState::UNEXPLORED)
+			{
+				child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, arc.arc);
+				frontier.push(arc.node, newNodeCost);
+			}
+			else if (child.getStatus() == NodeState::FRONTIER && newNodeCost < child.getPathCost())
+			{
+				child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, arc.arc);
+				frontier.decreaseKey(arc.node, newNodeCost);
+			}
+		}
+	}
+
+	context.clear();
+}
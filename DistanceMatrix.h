@@ -0,0 +1,102 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * DistanceMatrix.h
+ */
+
+#ifndef DISTANCE_MATRIX_H
+#define DISTANCE_MATRIX_H
+
+#include <cstdint>
+#include <vector>
+#include "GraphTypes.h"
+#include "Graph.h"
+#include "ContractionHierarchy.h"
+#include "SearchContext.h"
+#include "Frontier.h"
+
+using std::vector;
+
+
+// ---------------------------------------------------------------------------------/
+// The DistanceMatrix class computes the cost of the shortest route from every		/
+// node of a list of sources to every node of a list of targets, in one call.		/
+// The costs are returned as a dense matrix, row by row: the cost from source i		/
+// to target j is at [i * targetCount + j], and is infinite if there is no route.	/
+// Nothing is printed, and no routes are kept, only their costs.					/
+//																					/
+// Work is shared across the targets in one of two ways:							/
+//																					/
+//		Without a hierarchy	:	one uniform cost search per source, which stops		/
+//								once every target is settled, and reads all of		/
+//								that row's costs off the one search tree.			/
+//		With a hierarchy	:	the bucket method. An upward search from every		/
+//								target, over the downward arcs, leaves a bucket		/
+//								entry (target, cost) at each node it settles.		/
+//								Then an upward search from every source adds its	/
+//								cost to each entry in the buckets it settles, and	/
+//								keeps the smallest sum per target. The cost is		/
+//								one small search per source and per target,			/
+//								rather than one per pair.							/
+//																					/
+// Without a hierarchy, a call takes the Graph's edge costs when it starts, as		/
+// a search does, so every cell is for the same costs even if						/
+// Graph::updateEdgeCosts() replaces them part way through.							/
+//																					/
+// A DistanceMatrix keeps its search state between calls, so one object should		/
+// be used by one thread at a time; any number can share a Graph and hierarchy.		/
+// ---------------------------------------------------------------------------------/
+
+class DistanceMatrix
+{
+public:
+
+	// Constructors
+	//
+
+	explicit DistanceMatrix(const Graph&);
+	DistanceMatrix(const Graph&, const ContractionHierarchy&);
+
+	// public utility functions
+	//
+
+	void compute(const vector<nodeIndex>&, const vector<nodeIndex>&, vector<float>&);
+
+private:
+	// a node settled by a search, and its cost from the search's start
+	struct Settled
+	{
+		nodeIndex node;
+		float cost;
+	};
+
+	// a target's upward search reached the bucket's node, at this cost
+	struct BucketEntry
+	{
+		std::uint32_t column;
+		float cost;
+	};
+
+	const Graph& graph;
+	const ContractionHierarchy* hierarchy;
+	SearchContext context;
+	Frontier frontier;
+
+	// the nodes settled by the last search, and which nodes are targets
+	vector<Settled> settled;
+	vector<std::uint8_t> isTarget;
+
+	// the buckets of every node, in CSR form
+	vector<std::uint32_t> bucketOffset;
+	vector<BucketEntry> bucketList;
+
+	// private utility functions
+	//
+
+	void computeWithTrees(const vector<nodeIndex>&, const vector<nodeIndex>&, const float*, vector<float>&);
+	void computeWithBuckets(const vector<nodeIndex>&, const vector<nodeIndex>&, vector<float>&);
+	void searchGraph(const nodeIndex, const float*, unsigned);
+	void searchUpwards(const nodeIndex, const bool);
+};
+
+#endif /* DISTANCE_MATRIX_H */
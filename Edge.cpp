@@ -8,46 +8,39 @@
 #include <sstream>
 #include <cstdlib>
 #include "Edge.h"
-#include "Node.h"
+#include "Graph.h"
 
 using namespace std;
 
-Edge::Edge(nodePtr tail, nodePtr head, const float cost, const string& id) : ptrTailNode(tail), ptrHeadNode(head), edgeID(id)
+Edge::Edge(const nodeIndex tail, const nodeIndex head, const float cost, string_view id) : tailNode(tail), headNode(head), edgeID(id)
 {
 	setEdgeCost(cost);
 }
 
-Edge::~Edge()
-{
-	// This is only for debug purposes
-	//cout << "Destroy edge from " << ptrTailNode->getNodeID() << " to " << ptrHeadNode->getNodeID() << endl;
-	//system("PAUSE");
-}
-
-string Edge::getEdgeID() const
+string_view Edge::getEdgeID() const
 {
 	return edgeID;
 }
-	
+
 float Edge::getEdgeCost() const
 {
 	return edgeCost;
 }
 
-nodePtr Edge::getHeadNode() const
+nodeIndex Edge::getHeadNode() const
 {
-	return ptrHeadNode;
+	return headNode;
 }
 
-nodePtr Edge::getTailNode() const
+nodeIndex Edge::getTailNode() const
 {
-	return ptrTailNode;
+	return tailNode;
 }
 
-string Edge::toString() const
+string Edge::toString(const Graph& graph) const
 {
 	stringstream a;
-	a << "Edge : " << ptrTailNode->getNodeID() << " -> " << ptrHeadNode->getNodeID();
+	a << "Edge : " << graph.nodeName(tailNode) << " -> " << graph.nodeName(headNode);
 	a << " : " << getEdgeCost() << "km via " << getEdgeID();
 	return a.str();
 }
@@ -8,62 +8,66 @@
 #define EDGE_H
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <boost/shared_ptr.hpp>
-#include <boost/weak_ptr.hpp>
+#include "GraphTypes.h"
 
 
 // Explicitly call out types we are using, instead of "using namespace"
 // due to conflicts between boost and std smart pointer types
 using std::string;
+using std::string_view;
 using std::vector;
 
 
-// Forward declaration of class Node, as well as typedefs
-// An Edge is like an arrow, and contains a pointer to the
-// Node object at its head and tail both, as shared pointers.
-class Node;
-typedef boost::shared_ptr<Node> nodePtr;
+// Forward declaration of class Graph, which resolves the node
+// indices at the head and tail of an Edge into names for printing.
+class Graph;
 
 
 
 // ---------------------------------------------------------------------------------/
 // The Edge class defines a link between to Nodes in a graph data structure.		/
 // The edges are best thought of as arrows in a directed graph structure, and		/
-// contains a shared pointer to the head and tail.									/
+// contains the index of the Node at the head and tail.								/
 // There is also a cost defined for each edge, which can be thought of as a			/
 // distance in map type searches.													/
+//																					/
+// Edge is a small value type. The Graph does not keep Edge objects around, it		/
+// packs the heads and costs into its adjacency arrays; an Edge is only built		/
+// while reading a file, or on request through Graph::edgeAt(). The edge name is	/
+// a view of the string interned by the Graph, or of the line being parsed, so an	/
+// Edge must not outlive either of them.											/
 // ---------------------------------------------------------------------------------/
 
 class Edge
 {
 public:
 
-	// Constructor and destructor
+	// Constructor
 	//
 
-    Edge(nodePtr, nodePtr, const float, const string&);
-	~Edge();
+	Edge(const nodeIndex, const nodeIndex, const float, string_view);
 
 	// Setters and getters
 	// Data members cannot be changed after initialization
 	//
 
-	string getEdgeID() const;
+	string_view getEdgeID() const;
 	float getEdgeCost() const;
-	nodePtr getHeadNode() const;
-	nodePtr getTailNode() const;
+	nodeIndex getHeadNode() const;
+	nodeIndex getTailNode() const;
 
 	//  public utility functions
 	//
 
-	string toString() const;
-	
+	string toString(const Graph&) const;
+
 private:
-    string edgeID;
+	nodeIndex tailNode;
+	nodeIndex headNode;
 	float edgeCost;
-	nodePtr ptrTailNode;
-	nodePtr ptrHeadNode;
+	string_view edgeID;
 
 	// private utility functions
 	//
@@ -72,4 +76,4 @@ private:
 };
 
 
-#endif /* EDGE_H */
\ No newline at end of file
+#endif /* EDGE_H */
@@ -0,0 +1,147 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * FixedCostSearch.cpp
+ */
+
+#include <stdexcept>
+#include "FixedCostSearch.h"
+
+FixedCostSearch::FixedCostSearch(const Graph& g, const FixedCosts& c, const Frontier::Type frontierType)
+	: SearchBase(g), costs(c), frontier(frontierType), epoch(1), goalCost(INFINITE_FIXED_COST)
+{
+	// empty constructor
+}
+
+FixedCostSearch::Label& FixedCostSearch::labelAt(const nodeIndex n)
+{
+	// a label with an older epoch reads as unreached
+	Label& label = labels[n];
+	if (label.epoch != epoch)
+	{
+		label.epoch = epoch;
+		label.cost = INFINITE_FIXED_COST;
+		label.parentNode = INVALID_NODE;
+		label.parentAction = INVALID_EDGE;
+	}
+	return label;
+}
+
+void FixedCostSearch::start()
+{
+	// takes the current table, and puts the initial node in the frontier with cost 0.
+	// New labels are stamped with epoch 0, which is never current
+	table = costs.table();
+	if (table->size() != graph.edgeCount())
+	{
+		throw runtime_error("Fixed point costs do not match the graph");
+	}
+
+	if (labels.size() != graph.nodeCount())
+	{
+		const Label stale = { 0, INFINITE_FIXED_COST, INVALID_NODE, INVALID_EDGE };
+		labels.assign(graph.nodeCount(), stale);
+	}
+	context.prepare(graph.nodeCount());
+	frontier.prepare(graph.nodeCount());
+	goalCost = INFINITE_FIXED_COST;
+
+	labelAt(initialNode).cost = 0;
+	frontier.push(initialNode, fixedCost(0));
+}
+
+void FixedCostSearch::collectStats()
+{
+	stats.addFrontier(frontier);
+}
+
+void FixedCostSearch::finish()
+{
+	// starts a new epoch, as SearchContext does, and lets go of the table.
+	// The frontier is only left with nodes in it if the search threw
+	SearchBase::finish();
+	table.reset();
+	frontier.clear();
+
+	++epoch;
+	if (epoch == 0)
+	{
+		for (vector<Label>::iterator it = labels.begin(); it != labels.end(); ++it)
+		{
+			it->epoch = 0;
+		}
+		epoch = 1;
+	}
+}
+
+fixedCost FixedCostSearch::routeCost() const
+{
+	// the cost of the last route found, in units, or INFINITE_FIXED_COST if
+	// there was none
+	return goalCost;
+}
+
+SearchStatus FixedCostSearch::processNext()
+{
+	// if the frontier is empty and goal is not found, return failure
+	if (frontier.empty())
+		return SearchStatus::FAILURE;
+
+	// take the cheapest node from the frontier
+	const nodeIndex currentNode = frontier.pop();
+	const fixedCost currentCost = labelAt(currentNode).cost;
+
+	if (currentNode == goalNode)
+	{
+		goalCost = currentCost;
+		recordPath();
+		frontier.clear();
+		return SearchStatus::SUCCESS;
+	}
+
+	// relax the node's edges. An edge that would take a cost past the largest
+	// fixedCost is an error, rather than wrapping around to a small one
+	const vector<fixedCost>& edgeCosts = *table;
+	stats.edgesRelaxed += graph.edgesEnd(currentNode) - graph.edgesBegin(currentNode);
+	for( edgeIndex edge = graph.edgesBegin(currentNode); edge != graph.edgesEnd(currentNode); ++edge)
+	{
+		const fixedCost newNodeCost = currentCost + edgeCosts[edge];
+		if (newNodeCost < currentCost || newNodeCost == INFINITE_FIXED_COST)
+		{
+			throw out_of_range("Route cost out of range for fixed point costs");
+		}
+
+		const nodeIndex childNode = graph.edgeHead(edge);
+		Label& child = labelAt(childNode);
+		if (newNodeCost < child.cost)
+		{
+			const bool queued = (child.cost != INFINITE_FIXED_COST);
+			child.cost = newNodeCost;
+			child.parentNode = currentNode;
+			child.parentAction = edge;
+			if (queued)
+			{
+				frontier.decreaseKey(childNode, newNodeCost);
+			}
+			else
+			{
+				frontier.push(childNode, newNodeCost);
+			}
+		}
+	}
+
+	// Return that we are still searching
+	return SearchStatus::SEARCHING;
+}
+
+void FixedCostSearch::recordPath()
+{
+	// copies the route into the SearchBase context, back from the goal, so it
+	// can be traced and printed as the other searches' routes are
+
+	for (nodeIndex n = goalNode; n != INVALID_NODE; n = labels[n].parentNode)
+	{
+		const Label& label = labels[n];
+		context.stateAt(n).setSearchState(NodeState::EXPLORED, costs.toCost(label.cost), label.parentNode, label.parentAction);
+	}
+}
@@ -0,0 +1,78 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * FixedCostSearch.h
+ */
+
+#ifndef FIXED_COST_SEARCH_H
+#define FIXED_COST_SEARCH_H
+
+#include <cstdint>
+#include <vector>
+#include "SearchBase.h"
+#include "Frontier.h"
+#include "FixedCosts.h"
+
+
+using namespace std;
+
+// ---------------------------------------------------------------------------------/
+// The FixedCostSearch class is a uniform cost search on FixedCosts: route costs	/
+// are summed and compared as whole numbers, so the route found, and its cost,		/
+// are exact for the table, and do not depend on the order the costs were added.	/
+// The integer costs are also the frontier's keys, as they are, in either kind		/
+// of queue.																		/
+//																					/
+// Each node's search state is a 16 byte Label, its cost and the node and edge		/
+// it was reached by, stamped with the query's epoch as in SearchContext, so four	/
+// fit in a cache line. A node is reached when its cost is not infinite, and with	/
+// non-negative costs one that is reached and not in the frontier is never			/
+// improved on, so no status is kept. Once the goal is taken the route is			/
+// recorded in the SearchBase context, as for the hierarchy searches, with each		/
+// node's cost converted back from its units, and routeCost() gives it exactly.		/
+// ---------------------------------------------------------------------------------/
+
+class FixedCostSearch : public SearchBase
+{
+public:
+
+	// Constructor
+	//
+
+	FixedCostSearch(const Graph&, const FixedCosts&, const Frontier::Type = Frontier::D_ARY_HEAP);
+
+	// public utility functions
+	//
+
+	virtual SearchStatus processNext();
+	fixedCost routeCost() const;
+
+protected:
+	virtual void start();
+	virtual void collectStats();
+	virtual void finish();
+
+private:
+	struct Label
+	{
+		std::uint32_t epoch;
+		fixedCost cost;
+		nodeIndex parentNode;
+		edgeIndex parentAction;
+	};
+
+	const FixedCosts& costs;
+	FixedCosts::Table table;
+	Frontier frontier;
+	vector<Label> labels;
+	std::uint32_t epoch;
+	fixedCost goalCost;
+
+	// private utility functions
+	//
+
+	Label& labelAt(const nodeIndex);
+	void recordPath();
+};
+
+#endif /* FIXED_COST_SEARCH_H */
@@ -0,0 +1,70 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * FixedCosts.cpp
+ */
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "FixedCosts.h"
+
+using namespace std;
+
+FixedCosts::FixedCosts(const Graph& g, const double s) : graph(g), unitsPerCost(s)
+{
+	if (!(s > 0.0) || isinf(s))
+	{
+		throw runtime_error("Fixed point scale must be a positive number");
+	}
+
+	refresh();
+}
+
+void FixedCosts::refresh()
+{
+	// converts the graph's current edge costs, and makes them the current table.
+	// An edge cost too large to convert is an error, and leaves the table as it was
+
+	const Graph::CostTable costs = graph.costTable();
+	boost::shared_ptr<vector<fixedCost> > converted(new vector<fixedCost>(costs->size()));
+	for (size_t e = 0; e < costs->size(); ++e)
+	{
+		(*converted)[e] = toFixed((*costs)[e]);
+	}
+
+	boost::atomic_store(&currentTable, Table(converted));
+}
+
+FixedCosts::Table FixedCosts::table() const
+{
+	// the latest conversion, which stays valid for as long as it is held
+	return boost::atomic_load(&currentTable);
+}
+
+double FixedCosts::scale() const
+{
+	return unitsPerCost;
+}
+
+fixedCost FixedCosts::toFixed(const float cost) const
+{
+	// the nearest whole number of units. INFINITE_FIXED_COST is kept for
+	// routes that are not found, so the largest cost is one unit below it
+
+	const double units = floor(double(cost) * unitsPerCost + 0.5);
+	if (!(units >= 0.0) || units >= double(INFINITE_FIXED_COST))
+	{
+		throw out_of_range("Edge cost out of range for fixed point costs");
+	}
+	return fixedCost(units);
+}
+
+float FixedCosts::toCost(const fixedCost units) const
+{
+	if (units == INFINITE_FIXED_COST)
+	{
+		return numeric_limits<float>::infinity();
+	}
+	return float(units / unitsPerCost);
+}
@@ -0,0 +1,58 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * FixedCosts.h
+ */
+
+#ifndef FIXED_COSTS_H
+#define FIXED_COSTS_H
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "GraphTypes.h"
+#include "Graph.h"
+
+using std::vector;
+
+
+// ---------------------------------------------------------------------------------/
+// The FixedCosts class holds the Graph's edge costs as fixedCosts, whole numbers	/
+// of 1/scale of a cost unit, for FixedCostSearch. The default scale of 10000 is	/
+// decimetres for the kilometre costs of the sample maps, which leaves room for		/
+// routes of over 400,000 km in 32 bits. Each cost is rounded to the nearest		/
+// unit once, here, so the costs of routes then sum exactly, and two searches on	/
+// the same table agree to the unit.												/
+//																					/
+// Like CustomizableHierarchy, the table is made for the Graph's costs at the		/
+// time, and refresh() makes it again after Graph::updateEdgeCosts(). The new		/
+// table replaces the current one in one step, so a search keeps the table it		/
+// started with. One FixedCosts can be shared by the searches of many threads.		/
+// ---------------------------------------------------------------------------------/
+
+class FixedCosts
+{
+public:
+
+	typedef boost::shared_ptr<const vector<fixedCost> > Table;
+
+	// Constructor, which converts the graph's current costs
+	//
+
+	explicit FixedCosts(const Graph&, const double = 10000.0);
+
+	// public utility functions
+	//
+
+	void refresh();
+	Table table() const;
+	double scale() const;
+	fixedCost toFixed(const float) const;
+	float toCost(const fixedCost) const;
+
+private:
+	const Graph& graph;
+	double unitsPerCost;
+	Table currentTable;
+};
+
+#endif /* FIXED_COSTS_H */
@@ -0,0 +1,319 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * Frontier.cpp
+ */
+
+#include <cassert>
+#include <cstring>
+#include "Frontier.h"
+
+using namespace std;
+
+Frontier::Frontier(const Type t) : type(t), count(0), pushes(0), pops(0), decreases(0), peak(0), lastKey(0)
+{
+	// empty constructor
+}
+
+void Frontier::prepare(const nodeIndex nodeCount)
+{
+	// empties the frontier for a new search, and sizes the position index for
+	// a graph with the given number of nodes. The index is kept between
+	// searches, clear() only resets the nodes that were left in the frontier
+
+	clear();
+	pushes = 0;
+	pops = 0;
+	decreases = 0;
+	peak = 0;
+	if (position.size() != nodeCount)
+	{
+		position.assign(nodeCount, NOT_QUEUED);
+		if (type == RADIX_QUEUE)
+		{
+			bucketOf.assign(nodeCount, 0);
+		}
+	}
+}
+
+void Frontier::push(const nodeIndex node, const float key)
+{
+	push(node, keyBits(key));
+}
+
+void Frontier::push(const nodeIndex node, const fixedCost key)
+{
+	Entry entry = { key, node };
+	++count;
+	++pushes;
+	if (count > peak)
+	{
+		peak = count;
+	}
+
+	if (type == D_ARY_HEAP)
+	{
+		heap.push_back(entry);
+		position[node] = uint32_t(heap.size() - 1);
+		siftUp(heap.size() - 1);
+	}
+	else
+	{
+		addToBucket(entry);
+	}
+}
+
+nodeIndex Frontier::pop()
+{
+	// removes and returns the node with the smallest key.
+	// the frontier must not be empty
+
+	--count;
+	++pops;
+
+	if (type == D_ARY_HEAP)
+	{
+		const nodeIndex node = heap[0].node;
+		position[node] = NOT_QUEUED;
+
+		const Entry last = heap.back();
+		heap.pop_back();
+		if (!heap.empty())
+		{
+			placeInHeap(0, last);
+			siftDown(0);
+		}
+		return node;
+	}
+	else
+	{
+		if (buckets[0].empty())
+		{
+			refillFirstBucket();
+		}
+		const nodeIndex node = buckets[0].back().node;
+		buckets[0].pop_back();
+		position[node] = NOT_QUEUED;
+		return node;
+	}
+}
+
+float Frontier::topKey()
+{
+	// returns the smallest key, without removing its node.
+	// the frontier must not be empty
+
+	uint32_t bits;
+	if (type == D_ARY_HEAP)
+	{
+		bits = heap[0].key;
+	}
+	else
+	{
+		if (buckets[0].empty())
+		{
+			refillFirstBucket();
+		}
+		bits = buckets[0].back().key;
+	}
+
+	float key;
+	memcpy(&key, &bits, sizeof(key));
+	return key;
+}
+
+void Frontier::decreaseKey(const nodeIndex node, const float key)
+{
+	decreaseKey(node, keyBits(key));
+}
+
+void Frontier::decreaseKey(const nodeIndex node, const fixedCost bits)
+{
+	// lowers the key of a node that is in the frontier. A key that is
+	// not lower leaves the node where it is
+
+	++decreases;
+
+	if (type == D_ARY_HEAP)
+	{
+		const size_t i = position[node];
+		if (bits < heap[i].key)
+		{
+			heap[i].key = bits;
+			siftUp(i);
+		}
+	}
+	else
+	{
+		// the radix queue's keys only go up, so a lowered key must not go
+		// below the last key popped either
+		assert(bits >= lastKey);
+		if (bits < buckets[bucketOf[node]][position[node]].key)
+		{
+			removeFromBucket(node);
+			Entry entry = { bits, node };
+			addToBucket(entry);
+		}
+	}
+}
+
+void Frontier::clear()
+{
+	// empties the frontier, resetting the position of each node left in it
+
+	for (vector<Entry>::const_iterator it = heap.cbegin(); it != heap.cend(); ++it)
+	{
+		position[it->node] = NOT_QUEUED;
+	}
+	heap.clear();
+
+	for (unsigned b = 0; b < BUCKET_COUNT; ++b)
+	{
+		for (vector<Entry>::const_iterator it = buckets[b].cbegin(); it != buckets[b].cend(); ++it)
+		{
+			position[it->node] = NOT_QUEUED;
+		}
+		buckets[b].clear();
+	}
+
+	lastKey = 0;
+	count = 0;
+}
+
+uint32_t Frontier::keyBits(const float key)
+{
+	// the bits of a non-negative float, read as an unsigned integer, are in
+	// the same order as the floats, so keys are compared as integers.
+	// negative keys, and negative zero, are treated as zero
+
+	if (!(key > 0.0f))
+	{
+		return 0;
+	}
+	uint32_t bits;
+	memcpy(&bits, &key, sizeof(bits));
+	return bits;
+}
+
+void Frontier::siftUp(size_t i)
+{
+	const Entry entry = heap[i];
+	while (i > 0)
+	{
+		const size_t parent = (i - 1) / HEAP_ARITY;
+		if (!(entry.key < heap[parent].key))
+		{
+			break;
+		}
+		placeInHeap(i, heap[parent]);
+		i = parent;
+	}
+	placeInHeap(i, entry);
+}
+
+void Frontier::siftDown(size_t i)
+{
+	const Entry entry = heap[i];
+	const size_t size = heap.size();
+	for (;;)
+	{
+		const size_t first = i * HEAP_ARITY + 1;
+		if (first >= size)
+		{
+			break;
+		}
+
+		// find the child with the smallest key
+		size_t smallest = first;
+		const size_t last = (first + HEAP_ARITY < size) ? first + HEAP_ARITY : size;
+		for (size_t child = first + 1; child < last; ++child)
+		{
+			if (heap[child].key < heap[smallest].key)
+			{
+				smallest = child;
+			}
+		}
+
+		if (!(heap[smallest].key < entry.key))
+		{
+			break;
+		}
+		placeInHeap(i, heap[smallest]);
+		i = smallest;
+	}
+	placeInHeap(i, entry);
+}
+
+void Frontier::placeInHeap(const size_t i, const Entry& entry)
+{
+	heap[i] = entry;
+	position[entry.node] = uint32_t(i);
+}
+
+unsigned Frontier::bucketFor(const uint32_t key) const
+{
+	// keys at or below the last key popped go in the first bucket
+	if (key <= lastKey)
+	{
+		return 0;
+	}
+	unsigned bit = 31;
+	while (((key ^ lastKey) >> bit) == 0)
+	{
+		--bit;
+	}
+	return bit + 1;
+}
+
+void Frontier::addToBucket(const Entry& entry)
+{
+	const unsigned b = bucketFor(entry.key);
+	position[entry.node] = uint32_t(buckets[b].size());
+	bucketOf[entry.node] = uint8_t(b);
+	buckets[b].push_back(entry);
+}
+
+void Frontier::removeFromBucket(const nodeIndex node)
+{
+	// moves the last entry of the bucket into the node's place
+	vector<Entry>& bucket = buckets[bucketOf[node]];
+	const uint32_t i = position[node];
+	bucket[i] = bucket.back();
+	position[bucket[i].node] = i;
+	bucket.pop_back();
+	position[node] = NOT_QUEUED;
+}
+
+void Frontier::refillFirstBucket()
+{
+	// takes the first non-empty bucket, makes its smallest key the last key,
+	// and spreads its entries over the buckets below it. The smallest key
+	// lands in the first bucket
+
+	unsigned b = 1;
+	while (buckets[b].empty())
+	{
+		++b;
+	}
+
+	vector<Entry> moving;
+	moving.swap(buckets[b]);
+
+	lastKey = moving[0].key;
+	for (vector<Entry>::const_iterator it = moving.cbegin(); it != moving.cend(); ++it)
+	{
+		if (it->key < lastKey)
+		{
+			lastKey = it->key;
+		}
+	}
+	for (vector<Entry>::const_iterator it = moving.cbegin(); it != moving.cend(); ++it)
+	{
+		addToBucket(*it);
+	}
+
+	// every entry moved to a lower bucket, so give the bucket its storage
+	// back, and it is not reallocated next time
+	moving.clear();
+	moving.swap(buckets[b]);
+}
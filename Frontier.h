@@ -0,0 +1,121 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * Frontier.h
+ */
+
+#ifndef FRONTIER_H
+#define FRONTIER_H
+
+#include <cstdint>
+#include <vector>
+#include "GraphTypes.h"
+
+using std::vector;
+
+
+// ---------------------------------------------------------------------------------/
+// The Frontier class is the priority queue of a search: it holds node indices,		/
+// each with a float key, and pops the node with the smallest key first.			/
+//																					/
+// It remembers where every queued node is, so the key of a node already in the		/
+// frontier can be lowered in place (decreaseKey), instead of searching for the		/
+// node and re-inserting it. Two structures are available, chosen when the			/
+// frontier is constructed:															/
+//																					/
+//		D_ARY_HEAP	:	an indexed 4-ary heap. O(log n) push, pop and decreaseKey,	/
+//						and works for any order of keys.							/
+//		RADIX_QUEUE	:	a radix heap over the bits of the key. Push and				/
+//						decreaseKey are O(1), and pop is amortized O(1) per bit		/
+//						of the key. Keys must not go below the last key popped,		/
+//						which holds for uniform cost search, and for A* with a		/
+//						consistent heuristic. A smaller key is popped next, as if	/
+//						it were equal to the last key.								/
+//																					/
+// Keys are compared as non-negative floats; whole number costs work the same.		/
+// A search can instead give fixedCost keys, which are compared as they are,		/
+// but must not mix the two in one frontier.										/
+// The frontier counts its pushes, pops and decreaseKeys, and its largest size,		/
+// from one prepare() to the next, for the search statistics.						/
+// ---------------------------------------------------------------------------------/
+
+class Frontier
+{
+public:
+
+	// Enum for the queue structure
+	//
+	enum Type { D_ARY_HEAP, RADIX_QUEUE };
+
+	// Constructor
+	//
+
+	explicit Frontier(const Type = D_ARY_HEAP);
+
+	// public utility functions
+	//
+
+	void prepare(const nodeIndex);
+	void push(const nodeIndex, const float);
+	void push(const nodeIndex, const fixedCost);
+	nodeIndex pop();
+	float topKey();
+	void decreaseKey(const nodeIndex, const float);
+	void decreaseKey(const nodeIndex, const fixedCost);
+	void clear();
+
+	bool empty() const { return count == 0; }
+	std::size_t size() const { return count; }
+	Type getType() const { return type; }
+
+	std::uint64_t pushCount() const { return pushes; }
+	std::uint64_t popCount() const { return pops; }
+	std::uint64_t decreaseKeyCount() const { return decreases; }
+	std::size_t peakSize() const { return peak; }
+
+private:
+	struct Entry
+	{
+		std::uint32_t key;
+		nodeIndex node;
+	};
+
+	static constexpr std::uint32_t NOT_QUEUED = 0xFFFFFFFFu;
+	static constexpr unsigned HEAP_ARITY = 4;
+	static constexpr unsigned BUCKET_COUNT = 33;
+
+	Type type;
+	std::size_t count;
+
+	// the operation counts since prepare()
+	std::uint64_t pushes;
+	std::uint64_t pops;
+	std::uint64_t decreases;
+	std::size_t peak;
+
+	// where each node is : its index in the heap, or in its bucket
+	vector<std::uint32_t> position;
+
+	// the d-ary heap
+	vector<Entry> heap;
+
+	// the radix queue : bucket b > 0 holds the keys whose highest bit that differs
+	// from lastKey is bit b - 1, and bucket 0 the keys equal to lastKey
+	vector<Entry> buckets[BUCKET_COUNT];
+	vector<std::uint8_t> bucketOf;
+	std::uint32_t lastKey;
+
+	// private utility functions
+	//
+
+	static std::uint32_t keyBits(const float);
+	void siftUp(std::size_t);
+	void siftDown(std::size_t);
+	void placeInHeap(const std::size_t, const Entry&);
+	unsigned bucketFor(const std::uint32_t) const;
+	void addToBucket(const Entry&);
+	void removeFromBucket(const nodeIndex);
+	void refillFirstBucket();
+};
+
+#endif /* FRONTIER_H */
@@ -5,41 +5,197 @@
  */
 
 #include <exception>
+#include <iostream>
 #include <fstream>
 #include <iomanip>
-#include <boost/tokenizer.hpp>
-#include <boost/lexical_cast.hpp>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include "Graph.h"
+#include "GraphFile.h"
+#include "LineReader.h"
+#include "CsvParser.h"
+#include "ThreadPool.h"
 
-nodePtr Graph::findNode(const string& nodeName) const
+using namespace boost;
+
+// a text file is split into chunks of at least this many bytes for loading,
+// so small files are not spread thinly over many threads
+static const size_t MIN_CHUNK_SIZE = 1 << 16;
+
+static bool isOffsetList(const MappedArray<uint32_t>& offsets, const uint64_t total)
 {
-	// this function simply iterates through the list of nodes
-	// and returns a pointer to it if it exists, or an empty 
-	// shared_ptr if not found
+	// offsets into a list of total elements start at 0, never go down, and end at total
+	if (offsets.empty() || offsets[0] != 0 || offsets[offsets.size() - 1] != total)
+	{
+		return false;
+	}
+	for (size_t i = 1; i < offsets.size(); ++i)
+	{
+		if (offsets[i] < offsets[i - 1])
+		{
+			return false;
+		}
+	}
+	return true;
+}
 
-	nodeVecConstIterator it = nodeList.cbegin();
+static bool isIndexList(const MappedArray<uint32_t>& indices, const uint64_t limit)
+{
+	// every index is below limit
+	for (const uint32_t* it = indices.begin(); it != indices.end(); ++it)
+	{
+		if (*it >= limit)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+struct Graph::LoadChunk
+{
+	// the lines parsed by this chunk, from the start of a line
+	// to the start of another line, or the end of the file
+	const char* begin;
+	const char* end;
+
+	// nodes read, in the order of the file. The names are stored back to back,
+	// with their hashes, so they can be interned without hashing them again
+	string nameChars;
+	vector<size_t> nameEnds;
+	vector<uint32_t> nameHashes;
+	vector<float> latitudes;
+	vector<float> longitudes;
+
+	// edges read, in the order of the file, with their names interned
+	// in a table local to the chunk
+	vector<PendingEdge> edges;
+	StringTable edgeNames;
 
-	while(it!=nodeList.cend())
+	// the first error found in the chunk. The lines before it were read,
+	// the lines after it were not
+	std::exception_ptr error;
+};
+
+static vector<const char*> splitAtLines(const char* begin, const char* end, const unsigned threadCount)
+{
+	// splits the text [begin, end) into about four chunks per thread, and moves
+	// every cut forward to the start of a line, so no line is split.
+	// returns the cuts, including begin and end
+
+	const size_t length = end - begin;
+	const size_t parts = max(size_t(1), min(size_t(threadCount) * 4, length / MIN_CHUNK_SIZE));
+
+	vector<const char*> cuts(1, begin);
+	for (size_t p = 1; p < parts; ++p)
 	{
-		if ( (*it)->getNodeID() == nodeName )
+		const char* cut = max(begin + length * p / parts, cuts.back());
+		const char* newline = static_cast<const char*>(memchr(cut - 1, '\n', end - cut + 1));
+		cut = (newline != 0) ? newline + 1 : end;
+		if (cut > cuts.back() && cut < end)
 		{
-			return (*it);
+			cuts.push_back(cut);
 		}
-		++it;
 	}
+	cuts.push_back(end);
+	return cuts;
+}
+
+static void findBlankLines(ThreadPool& pool, const char* begin, const char* end, const char*& first, const char*& second)
+{
+	// finds the starts of the first two blank lines of the text [begin, end),
+	// or end if there are fewer. Each chunk records its own first two,
+	// which must include the first two of the whole text
+
+	const vector<const char*> cuts = splitAtLines(begin, end, pool.size());
+	vector<vector<const char*> > found(cuts.size() - 1);
+
+	for (size_t c = 0; c + 1 < cuts.size(); ++c)
+	{
+		pool.submit([&cuts, &found, c]()
+		{
+			LineReader lines(cuts[c], cuts[c + 1]);
+			string_view line;
+			const char* lineStart = lines.position();
+			while (found[c].size() < 2 && lines.nextLine(line))
+			{
+				if (line.length() == 0)
+				{
+					found[c].push_back(lineStart);
+				}
+				lineStart = lines.position();
+			}
+		});
+	}
+	pool.wait();
+
+	vector<const char*> blanks;
+	for (size_t c = 0; c < found.size() && blanks.size() < 2; ++c)
+	{
+		blanks.insert(blanks.end(), found[c].begin(), found[c].end());
+	}
+	first = (blanks.size() > 0) ? blanks[0] : end;
+	second = (blanks.size() > 1) ? blanks[1] : end;
+}
+
+nodeIndex Graph::findNode(string_view name) const
+{
+	// node names are interned in the order the nodes are added, so the
+	// id of a name in the table is also the index of its node.
+	// returns INVALID_NODE if not found
+
+	return nodeNames.find(name);
+}
 
-	return boost::shared_ptr<Node>();
+string_view Graph::nodeName(const nodeIndex index) const
+{
+	return nodeNames.at(index);
 }
 
-nodePtr Graph::nodeAt(const int index) const
+Node Graph::nodeAt(const nodeIndex index) const
 {
-	// returns a pointer to the node at a given index in the list
+	// returns the node at a given index in the list
 	// best used when selecting nodes along with the printNodeList() function
 
-	return nodeList.at(index);
+	if (index >= nodeCount())
+	{
+		throw out_of_range("Node index out of range");
+	}
+	return Node(latitudeList[index], longitudeList[index]);
 }
 
-void Graph::readFile(const string& fileName)
+Edge Graph::edgeAt(const edgeIndex index) const
+{
+	// rebuilds an Edge value from the adjacency arrays, for printing
+
+	if (index >= edgeCount())
+	{
+		throw out_of_range("Edge index out of range");
+	}
+	return Edge(edgeTailList[index], edgeHeadList[index], costView[index], edgeNames.at(edgeNameList[index]));
+}
+
+Graph::Graph() : costView(0)
+{
+	// an empty graph
+	clear();
+}
+
+nodeIndex Graph::nodeCount() const
+{
+	return nodeIndex(latitudeList.size());
+}
+
+edgeIndex Graph::edgeCount() const
+{
+	return edgeIndex(edgeHeadList.size());
+}
+
+void Graph::readFile(const string& fileName, const unsigned threadCount)
 {
 	// this function takes a string for the file name as input, and attempts to parse
 	// the file to create a graph structure
@@ -52,37 +208,362 @@ void Graph::readFile(const string& fileName)
 	//
 	// Node names can include commas if the whole string is enclosed in quotation marks.
 	// Many file format checks are made, and errors thrown if found, which will cause program termination
-
-	ifstream inputFile;
-	string fileString;
+	//
+	// The file is mapped into memory, and parsed in place by parseText()
 
 	// Attempt to open the file, and throw an exception if cannot open
-	inputFile.open(fileName, ios::in);
-	if(!inputFile)
+	ifstream inputFile(fileName, ios::in | ios::binary | ios::ate);
+	if (!inputFile)
 	{
 		throw runtime_error("Could not open the file.");
 	}
+	const streamoff fileSize = inputFile.tellg();
+	inputFile.close();
+
+	// Reading a file replaces whatever graph was loaded before
+	clear();
+	if (fileSize <= 0)
+	{
+		buildAdjacency();
+		return;
+	}
+
+	interprocess::mapped_region region;
+	try
+	{
+		interprocess::file_mapping file(fileName.c_str(), interprocess::read_only);
+		interprocess::mapped_region(file, interprocess::read_only).swap(region);
+	}
+	catch (interprocess::interprocess_exception&)
+	{
+		throw runtime_error("Could not open the file.");
+	}
+	const char* fileBegin = static_cast<const char*>(region.get_address());
+	parseText(fileBegin, fileBegin + region.get_size(), threadCount);
+}
+
+void Graph::readText(string_view text, const unsigned threadCount)
+{
+	// builds the graph from text held in memory, in the same format as a file
+	// read by readFile(), such as a generated graph
+
+	clear();
+	parseText(text.data(), text.data() + text.size(), threadCount);
+}
+
+void Graph::parseText(const char* fileBegin, const char* fileEnd, const unsigned threadCount)
+{
+	// Each section of the text is split into chunks of whole lines that are
+	// parsed in parallel, on threadCount threads (one per hardware thread if 0).
+	// The chunks are merged in file order, so the node indices, the order of the
+	// edges, and the error reported for a bad file are the same as reading the
+	// file line by line.
+
+	if (fileBegin == fileEnd)
+	{
+		buildAdjacency();
+		return;
+	}
+
+	ThreadPool pool(threadCount);
+
+	// The nodes run up to the first blank line, and the edges from the line after it
+	// up to the second blank line, or the end of the file. Find the blank lines first
+	const char* nodeSectionEnd;
+	const char* edgeSectionEnd;
+	findBlankLines(pool, fileBegin, fileEnd, nodeSectionEnd, edgeSectionEnd);
+
+	const char* edgeSectionBegin = nodeSectionEnd;
+	if (nodeSectionEnd != fileEnd)
+	{
+		LineReader blankLine(nodeSectionEnd, fileEnd);
+		string_view line;
+		blankLine.nextLine(line);
+		edgeSectionBegin = blankLine.position();
+	}
+
+	// In the first section, read nodes. Each chunk parses its lines on its own,
+	// then the nodes are added to the graph chunk by chunk
 	
-	// In the first section, read an initial node, and loop until a blank line (length 0) is found
-	
-	getline(inputFile, fileString);
-	while (fileString.length() > 0)
+	vector<const char*> cuts = splitAtLines(fileBegin, nodeSectionEnd, pool.size());
+	vector<LoadChunk> chunks(cuts.size() - 1);
+	for (size_t c = 0; c < chunks.size(); ++c)
 	{
-		addNode(fileString);
-		getline(inputFile, fileString);
+		chunks[c].begin = cuts[c];
+		chunks[c].end = cuts[c + 1];
+		LoadChunk* chunk = &chunks[c];
+		pool.submit([chunk]() { parseNodes(*chunk); });
 	}
+	pool.wait();
 
-	// In the second section, read an initial edge, and loop until a blank line (length 0) is found
+	size_t nodeTotal = 0, nameTotal = 0;
+	for (vector<LoadChunk>::const_iterator it = chunks.cbegin(); it != chunks.cend(); ++it)
+	{
+		nodeTotal += it->latitudes.size();
+		nameTotal += it->nameChars.size();
+	}
+	nodeNames.reserve(uint32_t(min(nodeTotal, size_t(INVALID_NODE))), nameTotal);
+	latitudeList.reserve(nodeTotal);
+	longitudeList.reserve(nodeTotal);
+
+	for (vector<LoadChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+	{
+		mergeNodes(*it);
+		releaseChunk(*it);
+	}
+
+	// In the second section, read edges, the same way. The node names are only
+	// looked up from here on, so the chunks can share them
 	
-	getline(inputFile, fileString);
-	while (fileString.length() > 0)
+	cuts = splitAtLines(edgeSectionBegin, edgeSectionEnd, pool.size());
+	vector<LoadChunk>(cuts.size() - 1).swap(chunks);
+	for (size_t c = 0; c < chunks.size(); ++c)
 	{
-		addEdge(fileString);
-		getline(inputFile, fileString);
+		chunks[c].begin = cuts[c];
+		chunks[c].end = cuts[c + 1];
+		LoadChunk* chunk = &chunks[c];
+		pool.submit([this, chunk]() { parseEdges(*chunk); });
 	}
+	pool.wait();
 
-	// close the file
-	inputFile.close();
+	size_t edgeTotal = 0;
+	for (vector<LoadChunk>::const_iterator it = chunks.cbegin(); it != chunks.cend(); ++it)
+	{
+		edgeTotal += it->edges.size();
+	}
+	pendingEdges.reserve(edgeTotal);
+
+	for (vector<LoadChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+	{
+		mergeEdges(*it);
+		releaseChunk(*it);
+	}
+
+	// pack the edges that were read into the adjacency arrays
+	buildAdjacency();
+}
+
+void Graph::readBinaryFile(const string& fileName)
+{
+	// maps a binary graph file, written by writeBinaryFile(), into memory and
+	// points the graph's arrays at its sections. Nothing is parsed or copied,
+	// the operating system pages the data in as it is read.
+	//
+	// The header, and the size and alignment of every section, are checked
+	// against the node and edge counts before anything is used, and errors
+	// thrown if they do not match. Then every index in the file is checked to
+	// be in range, in one pass over the sections, so a corrupt file cannot
+	// lead a search outside the arrays.
+
+	boost::shared_ptr<interprocess::mapped_region> region;
+	try
+	{
+		interprocess::file_mapping file(fileName.c_str(), interprocess::read_only);
+		region.reset(new interprocess::mapped_region(file, interprocess::read_only));
+	}
+	catch (interprocess::interprocess_exception&)
+	{
+		throw runtime_error("Could not open the file.");
+	}
+
+	const char* base = static_cast<const char*>(region->get_address());
+	const uint64_t fileSize = region->get_size();
+
+	GraphFileHeader header;
+	if (fileSize < sizeof(header))
+	{
+		throw runtime_error("File format error : Binary graph file is truncated");
+	}
+	memcpy(&header, base, sizeof(header));
+
+	if (memcmp(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic)) != 0)
+	{
+		throw runtime_error("File format error : Not a binary graph file");
+	}
+	if (header.byteOrder != GRAPH_FILE_BYTE_ORDER)
+	{
+		throw runtime_error("File format error : Binary graph file has the wrong byte order");
+	}
+	if (header.version != GRAPH_FILE_VERSION)
+	{
+		throw runtime_error("File format error : Unsupported binary graph file version");
+	}
+
+	// expected element counts per section, zero where the count comes from
+	// the string table header (its character count, and its index size)
+	const uint64_t nodes = header.nodeCount;
+	const uint64_t edges = header.edgeCount;
+	const uint64_t elementSize[SECTION_COUNT] = { 4, 4, 4, 4, 4, 4, 4, 1, 4, 4, 1, 4, 4, 4, 4, 4, 4 };
+	const uint64_t elementCount[SECTION_COUNT] = { nodes, nodes, nodes + 1, edges, edges, edges, edges, 0, nodes + 1, 0, 0, 0, 0, nodes + 1, edges, 0, 0 };
+
+	for (int s = 0; s < SECTION_COUNT; ++s)
+	{
+		const uint64_t offset = header.sectionOffset[s];
+		const uint64_t size = header.sectionSize[s];
+		if (offset % GRAPH_FILE_ALIGNMENT != 0 || offset > fileSize || size > fileSize - offset ||
+			size % elementSize[s] != 0 || (elementCount[s] != 0 && size != elementCount[s] * elementSize[s]))
+		{
+			throw runtime_error("File format error : Binary graph file section is corrupt");
+		}
+	}
+
+	// the node numbering is there for every node, or not at all
+	const uint64_t originalSize = header.sectionSize[SECTION_ORIGINAL_ID];
+	if ((originalSize != 0 && originalSize != nodes * 4) || header.sectionSize[SECTION_CURRENT_ID] != originalSize)
+	{
+		throw runtime_error("File format error : Binary graph file section is corrupt");
+	}
+
+	clear();
+	mappedFile = region;
+
+	latitudeList.attach(reinterpret_cast<const float*>(base + header.sectionOffset[SECTION_LATITUDE]), nodes);
+	longitudeList.attach(reinterpret_cast<const float*>(base + header.sectionOffset[SECTION_LONGITUDE]), nodes);
+	edgeOffset.attach(reinterpret_cast<const edgeIndex*>(base + header.sectionOffset[SECTION_EDGE_OFFSET]), nodes + 1);
+	edgeHeadList.attach(reinterpret_cast<const nodeIndex*>(base + header.sectionOffset[SECTION_EDGE_HEAD]), edges);
+	boost::shared_ptr<MappedArray<float> > costs(new MappedArray<float>);
+	costs->attach(reinterpret_cast<const float*>(base + header.sectionOffset[SECTION_EDGE_COST]), edges);
+	publishCosts(costs);
+	edgeTailList.attach(reinterpret_cast<const nodeIndex*>(base + header.sectionOffset[SECTION_EDGE_TAIL]), edges);
+	edgeNameList.attach(reinterpret_cast<const uint32_t*>(base + header.sectionOffset[SECTION_EDGE_NAME]), edges);
+	reverseOffset.attach(reinterpret_cast<const edgeIndex*>(base + header.sectionOffset[SECTION_REVERSE_OFFSET]), nodes + 1);
+	reverseEdgeList.attach(reinterpret_cast<const edgeIndex*>(base + header.sectionOffset[SECTION_REVERSE_EDGE]), edges);
+	originalIdList.attach(reinterpret_cast<const nodeIndex*>(base + header.sectionOffset[SECTION_ORIGINAL_ID]), originalSize / 4);
+	currentIdList.attach(reinterpret_cast<const nodeIndex*>(base + header.sectionOffset[SECTION_CURRENT_ID]), originalSize / 4);
+
+	for (int table = 0; table < 2; ++table)
+	{
+		const int first = (table == 0) ? SECTION_NODE_NAME_CHARS : SECTION_EDGE_NAME_CHARS;
+		MappedArray<char> chars;
+		MappedArray<uint32_t> offsets;
+		MappedArray<uint32_t> slots;
+		chars.attach(base + header.sectionOffset[first], header.sectionSize[first]);
+		offsets.attach(reinterpret_cast<const uint32_t*>(base + header.sectionOffset[first + 1]), header.sectionSize[first + 1] / 4);
+		slots.attach(reinterpret_cast<const uint32_t*>(base + header.sectionOffset[first + 2]), header.sectionSize[first + 2] / 4);
+		try
+		{
+			((table == 0) ? nodeNames : edgeNames).attach(chars, offsets, slots);
+		}
+		catch (std::exception&)
+		{
+			clear();
+			throw runtime_error("File format error : Binary graph file string table is corrupt");
+		}
+	}
+
+	// node names are looked up by node index, so there is one per node
+	if (nodeNames.size() != nodes || !isOffsetList(edgeOffset, edges) || !isOffsetList(reverseOffset, edges) ||
+		!isIndexList(edgeHeadList, nodes) || !isIndexList(edgeTailList, nodes) || !isIndexList(reverseEdgeList, edges) ||
+		!isIndexList(edgeNameList, edgeNames.size()) || !isIndexList(originalIdList, nodes) || !isIndexList(currentIdList, nodes))
+	{
+		clear();
+		throw runtime_error("File format error : Binary graph file adjacency is corrupt");
+	}
+
+	// the two node numberings must undo each other
+	for (size_t n = 0; n < originalIdList.size(); ++n)
+	{
+		if (currentIdList[originalIdList[n]] != n)
+		{
+			clear();
+			throw runtime_error("File format error : Binary graph file node numbering is corrupt");
+		}
+	}
+
+	const float* costData = costs->data();
+	for (uint64_t e = 0; e < edges; ++e)
+	{
+		if (!(costData[e] >= 0.0f))
+		{
+			clear();
+			throw runtime_error("File format error : Binary graph file edge costs are corrupt");
+		}
+	}
+}
+
+void Graph::writeBinaryFile(const string& fileName) const
+{
+	// writes the graph in the binary format described in GraphFile.h, so it
+	// can later be loaded with readBinaryFile()
+
+	ofstream outputFile(fileName, ios::out | ios::binary | ios::trunc);
+	if (!outputFile)
+	{
+		throw runtime_error("Could not open the file.");
+	}
+
+	// the costs written are the current ones, with any updates
+	const CostTable costs = costTable();
+
+	const void* sectionData[SECTION_COUNT] = {
+		latitudeList.data(), longitudeList.data(), edgeOffset.data(),
+		edgeHeadList.data(), costs->data(), edgeTailList.data(), edgeNameList.data(),
+		nodeNames.characterArray().data(), nodeNames.offsetArray().data(), nodeNames.slotArray().data(),
+		edgeNames.characterArray().data(), edgeNames.offsetArray().data(), edgeNames.slotArray().data(),
+		reverseOffset.data(), reverseEdgeList.data(), originalIdList.data(), currentIdList.data() };
+
+	GraphFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+	header.version = GRAPH_FILE_VERSION;
+	header.byteOrder = GRAPH_FILE_BYTE_ORDER;
+	header.nodeCount = nodeCount();
+	header.edgeCount = edgeCount();
+	header.sectionSize[SECTION_LATITUDE] = latitudeList.size() * sizeof(float);
+	header.sectionSize[SECTION_LONGITUDE] = longitudeList.size() * sizeof(float);
+	header.sectionSize[SECTION_EDGE_OFFSET] = edgeOffset.size() * sizeof(edgeIndex);
+	header.sectionSize[SECTION_EDGE_HEAD] = edgeHeadList.size() * sizeof(nodeIndex);
+	header.sectionSize[SECTION_EDGE_COST] = costs->size() * sizeof(float);
+	header.sectionSize[SECTION_EDGE_TAIL] = edgeTailList.size() * sizeof(nodeIndex);
+	header.sectionSize[SECTION_EDGE_NAME] = edgeNameList.size() * sizeof(uint32_t);
+	header.sectionSize[SECTION_NODE_NAME_CHARS] = nodeNames.characterArray().size();
+	header.sectionSize[SECTION_NODE_NAME_OFFSETS] = nodeNames.offsetArray().size() * sizeof(uint32_t);
+	header.sectionSize[SECTION_NODE_NAME_SLOTS] = nodeNames.slotArray().size() * sizeof(uint32_t);
+	header.sectionSize[SECTION_EDGE_NAME_CHARS] = edgeNames.characterArray().size();
+	header.sectionSize[SECTION_EDGE_NAME_OFFSETS] = edgeNames.offsetArray().size() * sizeof(uint32_t);
+	header.sectionSize[SECTION_EDGE_NAME_SLOTS] = edgeNames.slotArray().size() * sizeof(uint32_t);
+	header.sectionSize[SECTION_REVERSE_OFFSET] = reverseOffset.size() * sizeof(edgeIndex);
+	header.sectionSize[SECTION_REVERSE_EDGE] = reverseEdgeList.size() * sizeof(edgeIndex);
+	header.sectionSize[SECTION_ORIGINAL_ID] = originalIdList.size() * sizeof(nodeIndex);
+	header.sectionSize[SECTION_CURRENT_ID] = currentIdList.size() * sizeof(nodeIndex);
+
+	// lay the sections out one after the other, each on an aligned offset
+	uint64_t offset = sizeof(header);
+	for (int s = 0; s < SECTION_COUNT; ++s)
+	{
+		offset = (offset + GRAPH_FILE_ALIGNMENT - 1) / GRAPH_FILE_ALIGNMENT * GRAPH_FILE_ALIGNMENT;
+		header.sectionOffset[s] = offset;
+		offset += header.sectionSize[s];
+	}
+
+	outputFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	const char padding[GRAPH_FILE_ALIGNMENT] = { 0 };
+	uint64_t written = sizeof(header);
+	for (int s = 0; s < SECTION_COUNT; ++s)
+	{
+		outputFile.write(padding, streamsize(header.sectionOffset[s] - written));
+		outputFile.write(static_cast<const char*>(sectionData[s]), streamsize(header.sectionSize[s]));
+		written = header.sectionOffset[s] + header.sectionSize[s];
+	}
+
+	if (!outputFile)
+	{
+		throw runtime_error("Could not write the file.");
+	}
+}
+
+bool Graph::isBinaryFile(const string& fileName)
+{
+	// checks whether a file starts with the binary graph file magic, so callers
+	// can pick readFile() or readBinaryFile() without relying on its name
+
+	ifstream inputFile(fileName, ios::in | ios::binary);
+	char magic[sizeof(GRAPH_FILE_MAGIC)];
+	if (!inputFile.read(magic, sizeof(magic)))
+	{
+		return false;
+	}
+	return memcmp(magic, GRAPH_FILE_MAGIC, sizeof(magic)) == 0;
 }
 
 void Graph::print() const
@@ -92,10 +573,13 @@ void Graph::print() const
 
 	cout << "\n\nGraph\n-----\n";
 
-	for(nodeVecConstIterator it=nodeList.cbegin(); it!=nodeList.cend(); ++it)
+	for (nodeIndex n = 0; n < nodeCount(); ++n)
 	{
-		cout << "Node : " << (*it)->getNodeID() << endl;
-		(*it)->printEdges();
+		cout << "Node : " << nodeName(n) << endl;
+		for (edgeIndex e = edgesBegin(n); e != edgesEnd(n); ++e)
+		{
+			cout << "   " << edgeAt(e).toString(*this) << endl;
+		}
 		cout << endl;
 	}
 
@@ -112,174 +596,525 @@ int Graph::printNodeList() const
 
 	int count = 0;
 	cout << "Nodes : \n";
-	for(nodeVecConstIterator it=nodeList.cbegin(); it!=nodeList.cend(); ++it, ++count)
+	for(nodeIndex n = 0; n < nodeCount(); ++n, ++count)
 	{
-		cout << setw(2) << count << " : " << (*it)->getNodeID() << endl;
+		cout << setw(2) << count << " : " << nodeName(n) << endl;
 	}
 	return --count;
 }
 
-void Graph::clearSearchState()
+void Graph::updateEdgeCosts(const vector<CostUpdate>& updates)
 {
-	// iterates over all nodes and clears their search states (parent node, cost, etc.)
-	// so the graph can be re-used for a new search
+	// applies a batch of new edge costs. The whole batch is checked before
+	// any of it is applied, then it is applied to a copy of the current costs,
+	// which replaces them in one step. Searches still running keep the table
+	// they started with
 
-	for(nodeVecConstIterator it=nodeList.cbegin(); it!=nodeList.cend(); ++it)
+	for (vector<CostUpdate>::const_iterator it = updates.cbegin(); it != updates.cend(); ++it)
 	{
-		(*it)->clearSearchState();
+		if (it->edge >= edgeCount())
+		{
+			throw out_of_range("Edge index out of range");
+		}
+		if (!(it->cost >= 0.0f) || it->cost == numeric_limits<float>::infinity())
+		{
+			throw runtime_error("Edge costs must be non-negative numbers");
+		}
 	}
+
+	const CostTable current = costTable();
+	vector<float> costs(current->begin(), current->end());
+	for (vector<CostUpdate>::const_iterator it = updates.cbegin(); it != updates.cend(); ++it)
+	{
+		costs[it->edge] = it->cost;
+	}
+
+	boost::shared_ptr<MappedArray<float> > table(new MappedArray<float>);
+	table->adopt(costs);
+	publishCosts(table);
 }
 
-void Graph::addNode(const string& nodeString)
+Graph::CostTable Graph::costTable() const
 {
-	// takes a string from the file, and parses it in CSV format
-	// using boost tokenizer.
-	// if the correct fields do not exist an exception is thrown
+	// the current edge costs, which stay valid for as long as they are held
+	return boost::atomic_load(&edgeCostList);
+}
 
-	string nodeID;
-	float data1, data2;
+void Graph::reorderNodes(const NodeOrder order)
+{
+	// renumbers the nodes in the order asked for, and rebuilds everything
+	// indexed by node to match. The edges are packed again from the new
+	// numbering, so the edges leaving a node keep their order, but their
+	// indices change. Not to be used while searches are running
 
-	// convert the string to a token list, separated by commas
-	tokenizer<escaped_list_separator<char> > tok(nodeString);
-	tokenizer<escaped_list_separator<char> >::iterator it=tok.begin();
-	
-	// go through the tokens, and try converting them to the expected type
-	// throw errors if incorrect fields are found by the lexical_cast
-	int count = 0;
-	while ( (count < 3) && (it!=tok.end()) )
+	vector<nodeIndex> newOrder;
+	if (order == HILBERT_ORDER)
 	{
-		try {
-			switch (count)
-			{
-			case 0:
-				nodeID = (*it);
-				break;
-			case 1:
-				data1 = lexical_cast<float, string>(*it);
-				break;
-			case 2:
-				data2 = lexical_cast<float, string>(*it);
-				break;
-			}
-		}
-		catch (bad_lexical_cast& e)
+		hilbertOrder(newOrder);
+	}
+	else
+	{
+		breadthFirstOrder(newOrder);
+	}
+
+	const nodeIndex count = nodeCount();
+	vector<nodeIndex> newIndex(count);
+	for (nodeIndex i = 0; i < count; ++i)
+	{
+		newIndex[newOrder[i]] = i;
+	}
+
+	vector<float> latitudes(count);
+	vector<float> longitudes(count);
+	vector<nodeIndex> originals(count);
+	vector<nodeIndex> currents(count);
+	StringTable names;
+	names.reserve(count, nodeNames.characterArray().size());
+	for (nodeIndex i = 0; i < count; ++i)
+	{
+		const nodeIndex old = newOrder[i];
+		latitudes[i] = latitudeList[old];
+		longitudes[i] = longitudeList[old];
+		names.intern(nodeName(old));
+		originals[i] = originalId(old);
+		currents[originals[i]] = i;
+	}
+
+	// the edges, with the current costs, in the order of their new tails
+	const CostTable costs = costTable();
+	pendingEdges.reserve(edgeCount());
+	for (nodeIndex i = 0; i < count; ++i)
+	{
+		for (edgeIndex e = edgesBegin(newOrder[i]); e != edgesEnd(newOrder[i]); ++e)
 		{
-			string errorString = "File format error : Did not recognize '" + nodeString + "' as a node";
-			throw runtime_error(errorString.c_str());
+			const PendingEdge edge = { i, newIndex[edgeHeadList[e]], (*costs)[e], edgeNameList[e] };
+			pendingEdges.push_back(edge);
 		}
-		++it;
-		++count;
 	}
 
-	// if the correct number of fields was found, add the node
-	// otherwise throw an error
-	if ((count == 3) && (it == tok.end()))
+	latitudeList.adopt(latitudes);
+	longitudeList.adopt(longitudes);
+	nodeNames = names;
+	originalIdList.adopt(originals);
+	currentIdList.adopt(currents);
+	buildAdjacency();
+}
+
+nodeIndex Graph::originalId(const nodeIndex index) const
+{
+	// the index the node had in the file it was read from
+	if (index >= nodeCount())
+	{
+		throw out_of_range("Node index out of range");
+	}
+	return originalIdList.size() ? originalIdList[index] : index;
+}
+
+nodeIndex Graph::findOriginalNode(const nodeIndex original) const
+{
+	// the node that had the given index in the file it was read from, or
+	// INVALID_NODE if there was none
+	if (original >= nodeCount())
 	{
-		addNode(nodeID, data1, data2);
+		return INVALID_NODE;
+	}
+	return currentIdList.size() ? currentIdList[original] : original;
+}
+
+bool Graph::nodeOrderFromName(const string& name, NodeOrder& order)
+{
+	if (name == "hilbert")
+	{
+		order = HILBERT_ORDER;
+	}
+	else if (name == "bfs")
+	{
+		order = BREADTH_FIRST_ORDER;
 	}
 	else
 	{
-		string errorString = "File format error : Did not recognize '" + nodeString + "' as a node";
-		throw runtime_error(errorString.c_str());
+		return false;
 	}
+	return true;
 }
 
-void Graph::addNode(const string& name, const float data1, const float data2)
+void Graph::clear()
 {
-	// before adding the node, try to find it
-	nodePtr nodeExists = findNode(name);
+	// empties the graph, releasing any mapped file
 
-	// if the node already exists, throw an error message
-	// if the node does not exist, add it to the list of nodes
-	if ( nodeList.size() > 0 && nodeExists )
+	latitudeList.clear();
+	longitudeList.clear();
+	nodeNames.clear();
+	originalIdList.clear();
+	currentIdList.clear();
+	edgeOffset.clear();
+	edgeOffset.push_back(0);
+	edgeHeadList.clear();
+	publishCosts(CostTable(new MappedArray<float>));
+	edgeTailList.clear();
+	edgeNameList.clear();
+	edgeNames.clear();
+	reverseOffset.clear();
+	reverseOffset.push_back(0);
+	reverseEdgeList.clear();
+	vector<PendingEdge>().swap(pendingEdges);
+	mappedFile.reset();
+}
+
+void Graph::publishCosts(const CostTable& table)
+{
+	// makes the table the current edge costs. The plain pointer is for
+	// edgeCost(), which is not used during an update
+	boost::atomic_store(&edgeCostList, table);
+	costView = table->data();
+}
+
+void Graph::hilbertOrder(vector<nodeIndex>& order) const
+{
+	// sorts the nodes by their place along a Hilbert curve through a 65536 by
+	// 65536 grid over the box around their coordinates. Nodes near each other
+	// on the curve are near each other on the map. Nodes in the same cell
+	// keep the order they had
+
+	const nodeIndex count = nodeCount();
+	order.clear();
+	if (count == 0)
 	{
-		string errorString = "File format error : Duplicate node '" + nodeExists->getNodeID() + "'";
-		throw runtime_error(errorString.c_str());
+		return;
 	}
-	else
+
+	const float lowLatitude = *min_element(latitudeList.begin(), latitudeList.end());
+	const float highLatitude = *max_element(latitudeList.begin(), latitudeList.end());
+	const float lowLongitude = *min_element(longitudeList.begin(), longitudeList.end());
+	const float highLongitude = *max_element(longitudeList.begin(), longitudeList.end());
+	const double latitudeScale = 65535.0 / max(1e-9, double(highLatitude) - lowLatitude);
+	const double longitudeScale = 65535.0 / max(1e-9, double(highLongitude) - lowLongitude);
+
+	vector<pair<uint32_t, nodeIndex> > keys(count);
+	for (nodeIndex n = 0; n < count; ++n)
+	{
+		uint32_t x = uint32_t((double(longitudeList[n]) - lowLongitude) * longitudeScale);
+		uint32_t y = uint32_t((double(latitudeList[n]) - lowLatitude) * latitudeScale);
+
+		// the distance along the curve, two bits per level from the top: which
+		// quarter the cell is in, then the cell turned to that quarter's curve
+		uint32_t d = 0;
+		for (uint32_t s = 0x8000; s > 0; s >>= 1)
+		{
+			const uint32_t rx = (x & s) ? 1 : 0;
+			const uint32_t ry = (y & s) ? 1 : 0;
+			d += s * s * ((3 * rx) ^ ry);
+			if (ry == 0)
+			{
+				if (rx == 1)
+				{
+					x = 0xFFFF - x;
+					y = 0xFFFF - y;
+				}
+				swap(x, y);
+			}
+		}
+		keys[n] = make_pair(d, n);
+	}
+
+	sort(keys.begin(), keys.end());
+	order.reserve(count);
+	for (vector<pair<uint32_t, nodeIndex> >::const_iterator it = keys.cbegin(); it != keys.cend(); ++it)
 	{
-		nodeList.push_back( nodePtr(new Node(name, data1, data2) ) );
+		order.push_back(it->second);
 	}
 }
 
-void Graph::addEdge(const string& edgeString)
+void Graph::breadthFirstOrder(vector<nodeIndex>& order) const
 {
-	// takes a string from the file, and parses it in CSV format
-	// using boost tokenizer.
-	// if the correct fields do not exist an exception is thrown
+	// the Cuthill-McKee order: breadth first through the edges, either way,
+	// from a node with the fewest edges in each part of the graph not yet
+	// reached, taking the neighbours of each node fewest edges first. Every
+	// node is near the nodes it was reached from
 
-	string tail, head, name;
-	float data1;
+	const nodeIndex count = nodeCount();
+	vector<pair<edgeIndex, nodeIndex> > byDegree(count);
+	for (nodeIndex n = 0; n < count; ++n)
+	{
+		byDegree[n] = make_pair(edgesEnd(n) - edgesBegin(n) + inEdgesEnd(n) - inEdgesBegin(n), n);
+	}
+	vector<pair<edgeIndex, nodeIndex> > starts(byDegree);
+	sort(starts.begin(), starts.end());
 
-	// convert the string to a token list, separated by commas
-	tokenizer<escaped_list_separator<char> > tok(edgeString);
-	tokenizer<escaped_list_separator<char> >::iterator it=tok.begin();
-	int count = 0;
+	order.clear();
+	order.reserve(count);
+	vector<uint8_t> reached(count, 0);
+	vector<pair<edgeIndex, nodeIndex> > next;
+
+	for (vector<pair<edgeIndex, nodeIndex> >::const_iterator start = starts.cbegin(); start != starts.cend(); ++start)
+	{
+		if (reached[start->second])
+		{
+			continue;
+		}
+		reached[start->second] = 1;
+		order.push_back(start->second);
 
-	// go through the tokens, and try converting them to the expected type
-	// throw errors if incorrect fields are found by the lexical_cast
-	while ( (count < 4) && (it!=tok.end()) )
+		for (size_t i = order.size() - 1; i < order.size(); ++i)
+		{
+			const nodeIndex n = order[i];
+			next.clear();
+			for (edgeIndex e = edgesBegin(n); e != edgesEnd(n); ++e)
+			{
+				if (!reached[edgeHeadList[e]])
+				{
+					next.push_back(byDegree[edgeHeadList[e]]);
+				}
+			}
+			for (edgeIndex e = inEdgesBegin(n); e != inEdgesEnd(n); ++e)
+			{
+				if (!reached[edgeTailList[inEdge(e)]])
+				{
+					next.push_back(byDegree[edgeTailList[inEdge(e)]]);
+				}
+			}
+
+			sort(next.begin(), next.end());
+			next.erase(unique(next.begin(), next.end()), next.end());
+			for (vector<pair<edgeIndex, nodeIndex> >::const_iterator it = next.cbegin(); it != next.cend(); ++it)
+			{
+				reached[it->second] = 1;
+				order.push_back(it->second);
+			}
+		}
+	}
+}
+
+void Graph::parseNodes(LoadChunk& chunk)
+{
+	// takes each line of the chunk, and parses it in CSV format.
+	// if the correct fields do not exist, or a coordinate is out of range,
+	// the error is kept in the chunk and the rest of the chunk is skipped
+
+	LineReader lines(chunk.begin, chunk.end);
+	CsvParser parser;
+	string_view nodeString;
+	string_view fields[3];
+
+	try
 	{
-		try {
-			switch (count)
+		while (lines.nextLine(nodeString))
+		{
+			float data1, data2;
+
+			// split the line into fields, and convert the coordinates to numbers
+			// throw errors if the field count is wrong or a coordinate is not a number
+			if (parser.split(nodeString, fields, 3) != 3 ||
+				!CsvParser::parseFloat(fields[1], data1) || !CsvParser::parseFloat(fields[2], data2))
 			{
-			case 0:
-				tail = (*it);
-				break;
-			case 1:
-				head = (*it);
-				break;
-			case 2:
-				data1 = lexical_cast<float, string>(*it);
-				break;
-			case 3:
-				name = (*it);
-				break;
+				string errorString = "File format error : Did not recognize '" + string(nodeString) + "' as a node";
+				throw runtime_error(errorString.c_str());
 			}
+
+			// build the node, so bad coordinates are rejected here
+			Node newNode(data1, data2);
+
+			chunk.nameChars.append(fields[0].data(), fields[0].size());
+			chunk.nameEnds.push_back(chunk.nameChars.size());
+			chunk.nameHashes.push_back(StringTable::hash(fields[0]));
+			chunk.latitudes.push_back(newNode.getLatitude());
+			chunk.longitudes.push_back(newNode.getLongitude());
+		}
+	}
+	catch (...)
+	{
+		chunk.error = current_exception();
+	}
+}
+
+void Graph::parseEdges(LoadChunk& chunk) const
+{
+	// takes each line of the chunk, and parses it in CSV format.
+	// if the correct fields do not exist, or a node is not found,
+	// the error is kept in the chunk and the rest of the chunk is skipped
+
+	LineReader lines(chunk.begin, chunk.end);
+	CsvParser parser;
+	string_view edgeString;
+	string_view fields[4];
+
+	try
+	{
+		while (lines.nextLine(edgeString))
+		{
+			float data1;
+
+			// split the line into fields, and convert the cost to a number
+			// throw errors if the field count is wrong or the cost is not a number
+			if (parser.split(edgeString, fields, 4) != 4 || !CsvParser::parseFloat(fields[2], data1))
+			{
+				string errorString = "File format error : Did not recognize '" + string(edgeString) + "' as an edge";
+				throw runtime_error(errorString.c_str());
+			}
+
+			// find the indices of the nodes at head and tail, based on the strings
+			// throw errors if either is not found
+			nodeIndex nodeTail = findNode(fields[0]);
+			if (nodeTail == INVALID_NODE)
+			{
+				string errorString = "File error : Node " + string(fields[0]) + " does not exist.";
+				throw runtime_error(errorString.c_str());
+			}
+			nodeIndex nodeHead = findNode(fields[1]);
+			if (nodeHead == INVALID_NODE)
+			{
+				string errorString = "File error : Node " + string(fields[1]) + " does not exist.";
+				throw runtime_error(errorString.c_str());
+			}
+
+			// after eliminating potential errors, create the edge and hold on to it
+			// until the whole edge section is read, see buildAdjacency()
+			Edge newEdge(nodeTail, nodeHead, data1, fields[3]);
+			PendingEdge pending = { nodeTail, nodeHead, newEdge.getEdgeCost(), chunk.edgeNames.intern(fields[3]) };
+			chunk.edges.push_back( pending );
 		}
-		catch (bad_lexical_cast& e)
+	}
+	catch (...)
+	{
+		chunk.error = current_exception();
+	}
+}
+
+void Graph::mergeNodes(LoadChunk& chunk)
+{
+	// adds the nodes of a parsed chunk to the graph, then throws the chunk's
+	// error, if it had one
+
+	size_t nameStart = 0;
+	for (size_t i = 0; i < chunk.nameHashes.size(); ++i)
+	{
+		string_view name(chunk.nameChars.data() + nameStart, chunk.nameEnds[i] - nameStart);
+		nameStart = chunk.nameEnds[i];
+
+		// interning the name returns the existing id if the node already exists,
+		// in which case throw an error message. Otherwise the new id equals the
+		// index the node gets in the list of nodes
+		nodeIndex nodeExists = nodeNames.intern(name, chunk.nameHashes[i]);
+		if ( nodeExists != nodeCount() )
 		{
-			string errorString = "File format error : Did not recognize '" + edgeString + "' as an edge";
+			string errorString = "File format error : Duplicate node '" + string(nodeName(nodeExists)) + "'";
 			throw runtime_error(errorString.c_str());
 		}
-		++it;
-		++count;
+		else
+		{
+			latitudeList.push_back( chunk.latitudes[i] );
+			longitudeList.push_back( chunk.longitudes[i] );
+		}
 	}
 
-	// if the correct number of fields was found, add the edge
-	// otherwise throw an error
-	if ((count == 4) && (it == tok.end()))
+	if (chunk.error)
 	{
-		addEdge(tail, head, data1, name);
+		rethrow_exception(chunk.error);
 	}
-	else
+}
+
+void Graph::mergeEdges(LoadChunk& chunk)
+{
+	// adds the edges of a parsed chunk to the pending edges, moving their
+	// names from the chunk's string table to the graph's.
+	// throws the chunk's error, if it had one
+
+	if (chunk.error)
 	{
-		string errorString = "File format error : Did not recognize '" + edgeString + "' as an edge";
-		throw runtime_error(errorString.c_str());
+		rethrow_exception(chunk.error);
+	}
+
+	vector<uint32_t> nameIds(chunk.edgeNames.size());
+	for (uint32_t id = 0; id < chunk.edgeNames.size(); ++id)
+	{
+		nameIds[id] = edgeNames.intern(chunk.edgeNames.at(id));
+	}
+
+	for (vector<PendingEdge>::iterator it = chunk.edges.begin(); it != chunk.edges.end(); ++it)
+	{
+		it->name = nameIds[it->name];
+		pendingEdges.push_back( *it );
 	}
 }
 
-void Graph::addEdge(const string& tail, const string& head, const float cost, const string& name)
+void Graph::releaseChunk(LoadChunk& chunk)
 {
-	// find the pointers to nodes at head and tail, based on the strings
-	// throw errors if either is not found
+	// frees the buffers of a chunk once it is merged, so the parsed copy of
+	// the file is let go of a chunk at a time instead of all at the end
+	string().swap(chunk.nameChars);
+	vector<size_t>().swap(chunk.nameEnds);
+	vector<uint32_t>().swap(chunk.nameHashes);
+	vector<float>().swap(chunk.latitudes);
+	vector<float>().swap(chunk.longitudes);
+	vector<PendingEdge>().swap(chunk.edges);
+	chunk.edgeNames.clear();
+}
+
+void Graph::buildAdjacency()
+{
+	// packs the pending edges into CSR form with a stable counting sort on the
+	// tail node: count the edges leaving each node, turn the counts into offsets,
+	// then drop every edge into the next free slot of its tail's range.
+	// Edges leaving a node keep the order they had in the file.
+
+	const nodeIndex numNodes = nodeCount();
+	const edgeIndex numEdges = edgeIndex(pendingEdges.size());
 
-	nodePtr nodeTail = findNode(tail);
-	if (!nodeTail)
+	vector<edgeIndex> offsets(numNodes + 1, 0);
+	for (vector<PendingEdge>::const_iterator it = pendingEdges.cbegin(); it != pendingEdges.cend(); ++it)
 	{
-		string errorString = "File error : Node " + tail + " does not exist.";
-		throw runtime_error(errorString.c_str());
+		++offsets[it->tail + 1];
 	}
-	nodePtr nodeHead = findNode(head);
-	if (!nodeHead)
+	for (nodeIndex n = 0; n < numNodes; ++n)
 	{
-		string errorString = "File error : Node " + head + " does not exist.";
-		throw runtime_error(errorString.c_str());
+		offsets[n + 1] += offsets[n];
 	}
-	
-	// after eliminating potential errors, create the edge, add it to the list
-	// and add it to the tail node's list of leaving edges
-	edgePtr newEdge = edgePtr(new Edge( nodeTail, nodeHead, cost, name) );
-	edgeList.push_back( newEdge );
-	nodeTail->addEdge( newEdge );	
+
+	vector<nodeIndex> heads(numEdges);
+	vector<float> costs(numEdges);
+	vector<nodeIndex> tails(numEdges);
+	vector<uint32_t> names(numEdges);
+
+	vector<edgeIndex> nextSlot(offsets.begin(), offsets.end() - 1);
+	for (vector<PendingEdge>::const_iterator it = pendingEdges.cbegin(); it != pendingEdges.cend(); ++it)
+	{
+		edgeIndex slot = nextSlot[it->tail]++;
+		heads[slot] = it->head;
+		costs[slot] = it->cost;
+		tails[slot] = it->tail;
+		names[slot] = it->name;
+	}
+
+	// the pending list is no longer needed, release its memory before the
+	// reverse index is allocated
+	vector<PendingEdge>().swap(pendingEdges);
+
+	// the reverse index is built the same way, counting sort on the head node,
+	// and lists forward edge indices, so edges entering a node keep CSR order
+	vector<edgeIndex> reverseOffsets(numNodes + 1, 0);
+	for (edgeIndex e = 0; e < numEdges; ++e)
+	{
+		++reverseOffsets[heads[e] + 1];
+	}
+	for (nodeIndex n = 0; n < numNodes; ++n)
+	{
+		reverseOffsets[n + 1] += reverseOffsets[n];
+	}
+
+	vector<edgeIndex> reverseEdges(numEdges);
+	nextSlot.assign(reverseOffsets.begin(), reverseOffsets.end() - 1);
+	for (edgeIndex e = 0; e < numEdges; ++e)
+	{
+		reverseEdges[nextSlot[heads[e]]++] = e;
+	}
+
+	edgeOffset.adopt(offsets);
+	edgeHeadList.adopt(heads);
+	boost::shared_ptr<MappedArray<float> > costTable(new MappedArray<float>);
+	costTable->adopt(costs);
+	publishCosts(costTable);
+	edgeTailList.adopt(tails);
+	edgeNameList.adopt(names);
+	reverseOffset.adopt(reverseOffsets);
+	reverseEdgeList.adopt(reverseEdges);
 }
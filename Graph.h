@@ -8,48 +8,182 @@
 #define GRAPH_H
 
 #include <vector>
+#include <boost/shared_ptr.hpp>
+#include "GraphTypes.h"
+#include "MappedArray.h"
+#include "StringTable.h"
 #include "Node.h"
 #include "Edge.h"
 
 using namespace std;
-using namespace boost;
+
+namespace boost { namespace interprocess { class mapped_region; } }
 
 // ---------------------------------------------------------------------------------/
 // The Graph class defines a graph data structure. It consists of both nodes (or	/
 // vertices) and edges (links) between the nodes.									/
 //																					/
-// Internally there is a list of nodes, and list of edges, each stored in a vector	/
-// with shared_ptr's to each element.												/
+// Nodes are addressed by their 32 bit index, and their coordinates are kept in		/
+// flat latitude and longitude arrays. The edges are stored in compressed sparse	/
+// row (CSR) form: the edges leaving node n occupy the range						/
+// [edgesBegin(n), edgesEnd(n)) of packed head and cost arrays, so scanning a		/
+// node's edges is a sequential read. A second CSR index lists the edges			/
+// entering each node, for searches that run backwards from the goal.				/
+//																					/
+// Node and edge names are interned in string tables, so each distinct name is		/
+// stored once. The node name table doubles as a hash index from name to node,		/
+// which keeps findNode, and therefore loading a file, at constant time per line.	/
+//																					/
+// The graph can be generated by reading in a formatted text file, or the same		/
+// text held in memory, or by mapping a binary graph file (see GraphFile.h)			/
+// written from one. A mapped graph uses the file's pages directly, so it loads		/
+// in constant time, and processes that map the same file share one copy of it		/
+// in the page cache.																/
+// Once loaded the graph is read-only, except for its edge costs; searches keep		/
+// their per-node state in a SearchContext of their own, so any number of them		/
+// can share one Graph.																/
 //																					/
-// Currently, the graph can only be generated by reading in a formatted text file,  /
-// although it could easily be extended to generate graphs from a console program.	/
+// The edge costs can be changed while searches are running, such as for			/
+// traffic, a batch at a time with updateEdgeCosts(). The batch is applied to a		/
+// copy of the cost table, which then replaces the current one in one step. A		/
+// search takes the table with costTable() when it starts, and keeps it to the		/
+// end, so it sees either all of a batch or none of it. edgeCost() reads the		/
+// current table directly, for code that does not run during an update, such		/
+// as loading and preprocessing. Updates are made from one thread at a time.		/
+//																					/
+// The nodes are numbered in the order of the file, which need not have anything	/
+// to do with where they are, so neighbouring nodes can be far apart in memory.		/
+// reorderNodes() renumbers them, along a Hilbert curve over their coordinates		/
+// or breadth first through the edges, so that a search's next nodes are mostly		/
+// near the ones it has just read. It keeps every node's name, and the index it		/
+// had in the file, see originalId(). Anything built from the graph before, such	/
+// as Landmarks or a ContractionHierarchy, has to be built again after it.			/
 // ---------------------------------------------------------------------------------/
 
 class Graph
 {
 public:
 
+	// a new cost for one edge, for updateEdgeCosts()
+	struct CostUpdate
+	{
+		edgeIndex edge;
+		float cost;
+	};
+
+	// a set of edge costs, shared by whoever is still using it
+	typedef boost::shared_ptr<const MappedArray<float> > CostTable;
+
+	// Enum for the order reorderNodes() puts the nodes in
+	//
+	enum NodeOrder { HILBERT_ORDER, BREADTH_FIRST_ORDER };
+
+	// Constructor
+	//
+
+	Graph();
+
 	// public utility functions
 	//
 
-	nodePtr findNode(const string&) const;
-	nodePtr nodeAt(const int) const;
-	void readFile(const string&);
+	nodeIndex findNode(string_view) const;
+	string_view nodeName(const nodeIndex) const;
+	Node nodeAt(const nodeIndex) const;
+	Edge edgeAt(const edgeIndex) const;
+	nodeIndex nodeCount() const;
+	edgeIndex edgeCount() const;
+	void readFile(const string&, const unsigned = 0);
+	void readText(string_view, const unsigned = 0);
+	void readBinaryFile(const string&);
+	void writeBinaryFile(const string&) const;
+	static bool isBinaryFile(const string&);
+	void updateEdgeCosts(const vector<CostUpdate>&);
+	CostTable costTable() const;
+	void reorderNodes(const NodeOrder);
+	nodeIndex originalId(const nodeIndex) const;
+	nodeIndex findOriginalNode(const nodeIndex) const;
+	static bool nodeOrderFromName(const string&, NodeOrder&);
 	void print() const;
 	int printNodeList() const;
-	void clearSearchState();
+
+	// Adjacency is exposed as part of Graph's public interface
+	// using inlines, as it is read on every edge relaxation.
+
+	edgeIndex edgesBegin(const nodeIndex n) const { return edgeOffset[n]; }
+	edgeIndex edgesEnd(const nodeIndex n) const { return edgeOffset[n + 1]; }
+	nodeIndex edgeHead(const edgeIndex e) const { return edgeHeadList[e]; }
+	nodeIndex edgeTail(const edgeIndex e) const { return edgeTailList[e]; }
+	float edgeCost(const edgeIndex e) const { return costView[e]; }
+
+	// The edges entering node n are inEdge(i) for i in [inEdgesBegin(n), inEdgesEnd(n))
+
+	edgeIndex inEdgesBegin(const nodeIndex n) const { return reverseOffset[n]; }
+	edgeIndex inEdgesEnd(const nodeIndex n) const { return reverseOffset[n + 1]; }
+	edgeIndex inEdge(const edgeIndex i) const { return reverseEdgeList[i]; }
+
+	// Coordinates are read by the distance heuristics on every edge relaxation.
+	// The raw arrays are for kernels that work on a block of nodes at once
+
+	float nodeLatitude(const nodeIndex n) const { return latitudeList[n]; }
+	float nodeLongitude(const nodeIndex n) const { return longitudeList[n]; }
+	const MappedArray<float>& latitudeArray() const { return latitudeList; }
+	const MappedArray<float>& longitudeArray() const { return longitudeList; }
+	const nodeIndex* edgeHeadBlock(const nodeIndex n) const { return edgeHeadList.data() + edgeOffset[n]; }
 
 private:
-	vector<nodePtr> nodeList;
-	vector<edgePtr> edgeList;
+	// node coordinates
+	MappedArray<float> latitudeList;
+	MappedArray<float> longitudeList;
+	StringTable nodeNames;
+
+	// the index each node had when it was read from the text file, and the
+	// other way round, both empty until the nodes are reordered
+	MappedArray<nodeIndex> originalIdList;
+	MappedArray<nodeIndex> currentIdList;
+
+	// CSR adjacency, plus the per-edge data only needed for printing
+	MappedArray<edgeIndex> edgeOffset;
+	MappedArray<nodeIndex> edgeHeadList;
+	CostTable edgeCostList;
+	const float* costView;
+	MappedArray<nodeIndex> edgeTailList;
+	MappedArray<std::uint32_t> edgeNameList;
+	StringTable edgeNames;
+
+	// reverse CSR index, the edges entering each node grouped by head
+	MappedArray<edgeIndex> reverseOffset;
+	MappedArray<edgeIndex> reverseEdgeList;
+
+	// the mapped binary file the arrays point into, if any
+	boost::shared_ptr<boost::interprocess::mapped_region> mappedFile;
+
+	// edges read from the file, waiting to be packed into the CSR arrays
+	struct PendingEdge
+	{
+		nodeIndex tail;
+		nodeIndex head;
+		float cost;
+		std::uint32_t name;
+	};
+	vector<PendingEdge> pendingEdges;
+
+	// a run of whole lines of a text file, parsed by one loader thread
+	struct LoadChunk;
 
 	// private utility functions
 	//
 
-	void addNode(const string&);
-	void addNode(const string&, const float, const float);
-	void addEdge(const string&);
-	void addEdge(const string&, const string&, const float, const string&);
+	void clear();
+	void publishCosts(const CostTable&);
+	void parseText(const char*, const char*, const unsigned);
+	static void parseNodes(LoadChunk&);
+	void parseEdges(LoadChunk&) const;
+	void mergeNodes(LoadChunk&);
+	void mergeEdges(LoadChunk&);
+	static void releaseChunk(LoadChunk&);
+	void buildAdjacency();
+	void hilbertOrder(vector<nodeIndex>&) const;
+	void breadthFirstOrder(vector<nodeIndex>&) const;
 };
 
-#endif /* GRAPH_H */
\ No newline at end of file
+#endif /* GRAPH_H */
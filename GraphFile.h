@@ -0,0 +1,65 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * GraphFile.h
+ */
+
+#ifndef GRAPH_FILE_H
+#define GRAPH_FILE_H
+
+#include <cstdint>
+
+
+// ---------------------------------------------------------------------------------/
+// Layout of the binary graph file, written by Graph::writeBinaryFile() and			/
+// mapped into memory by Graph::readBinaryFile().									/
+//																					/
+// The file starts with a GraphFileHeader, followed by one section per array of		/
+// the Graph. Every array is stored exactly as it is laid out in memory, so the		/
+// Graph can point straight into the mapped file instead of copying it. Each		/
+// section starts on a 64 byte boundary, and the header records the offset and		/
+// size in bytes of every section.													/
+//																					/
+// The file is written in the byte order of the machine that wrote it; a reader		/
+// with a different byte order, or a different format version, rejects it.			/
+// ---------------------------------------------------------------------------------/
+
+const char GRAPH_FILE_MAGIC[8] = { 'G', 'M', 'S', 'G', 'R', 'A', 'P', 'H' };
+const std::uint32_t GRAPH_FILE_VERSION = 3;
+const std::uint32_t GRAPH_FILE_BYTE_ORDER = 0x01020304u;
+const std::uint64_t GRAPH_FILE_ALIGNMENT = 64;
+
+enum GraphFileSection
+{
+	SECTION_LATITUDE,				// float per node
+	SECTION_LONGITUDE,				// float per node
+	SECTION_EDGE_OFFSET,			// edgeIndex per node, plus one
+	SECTION_EDGE_HEAD,				// nodeIndex per edge
+	SECTION_EDGE_COST,				// float per edge
+	SECTION_EDGE_TAIL,				// nodeIndex per edge
+	SECTION_EDGE_NAME,				// edge name id per edge
+	SECTION_NODE_NAME_CHARS,		// node name string table
+	SECTION_NODE_NAME_OFFSETS,
+	SECTION_NODE_NAME_SLOTS,
+	SECTION_EDGE_NAME_CHARS,		// edge name string table
+	SECTION_EDGE_NAME_OFFSETS,
+	SECTION_EDGE_NAME_SLOTS,
+	SECTION_REVERSE_OFFSET,			// edgeIndex per node, plus one
+	SECTION_REVERSE_EDGE,			// edgeIndex per edge
+	SECTION_ORIGINAL_ID,			// nodeIndex per node, or empty if not reordered
+	SECTION_CURRENT_ID,				// nodeIndex per node, or empty if not reordered
+	SECTION_COUNT
+};
+
+struct GraphFileHeader
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t byteOrder;
+	std::uint32_t nodeCount;
+	std::uint32_t edgeCount;
+	std::uint64_t sectionOffset[SECTION_COUNT];
+	std::uint64_t sectionSize[SECTION_COUNT];
+};
+
+#endif /* GRAPH_FILE_H */
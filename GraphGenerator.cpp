@@ -0,0 +1,326 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * GraphGenerator.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include "Node.h"
+#include "GraphGenerator.h"
+
+using namespace std;
+
+// the nodes are placed on a flat map around this point, with x east and y
+// north in km, and converted to degrees with the scale at the origin
+static const double ORIGIN_LATITUDE = 40.0;
+static const double ORIGIN_LONGITUDE = -100.0;
+static const double KM_PER_DEGREE = 111.19492664;
+static const double TO_RAD = 0.01745329251994329;
+
+// the road network's nodes are moved up to this far (in km) from the grid, which
+// keeps its streets from crossing, and one row and column in this many is arterial
+static const double ROAD_JITTER = 0.3;
+static const nodeIndex ARTERIAL_SPACING = 8;
+static const double MISSING_STREETS = 0.2;
+static const double ONE_WAY_STREETS = 0.1;
+
+// the number of nearest neighbours each node of a geometric graph is joined to
+static const size_t NEIGHBOUR_COUNT = 4;
+
+GraphGenerator::GraphGenerator(const Shape shape, const nodeIndex count, const uint32_t seed) : random(seed)
+{
+	if (count == 0 || count == INVALID_NODE)
+	{
+		throw out_of_range("Node count out of range");
+	}
+
+	latitudes.reserve(count);
+	longitudes.reserve(count);
+
+	if (shape == GEOMETRIC)
+	{
+		makeGeometric(count);
+	}
+	else
+	{
+		makeGrid(count, shape == ROAD);
+	}
+}
+
+nodeIndex GraphGenerator::nodeCount() const
+{
+	return nodeIndex(latitudes.size());
+}
+
+edgeIndex GraphGenerator::edgeCount() const
+{
+	return edgeIndex(edges.size());
+}
+
+void GraphGenerator::write(ostream& out) const
+{
+	// writes the graph in the text format: the nodes, a blank line, then the edges.
+	// Nine significant digits read back as the same float, so the graph read
+	// from the text is the graph generated
+
+	const streamsize oldPrecision = out.precision(9);
+
+	for (nodeIndex i = 0; i < nodeCount(); ++i)
+	{
+		out << 'N' << i << ',' << latitudes[i] << ',' << longitudes[i] << '\n';
+	}
+	out << '\n';
+
+	for (vector<GeneratedEdge>::const_iterator it = edges.cbegin(); it != edges.cend(); ++it)
+	{
+		out << 'N' << it->tail << ",N" << it->head << ',' << it->cost << ',' << edgeNames[it->name] << '\n';
+	}
+
+	out.precision(oldPrecision);
+}
+
+void GraphGenerator::writeFile(const string& fileName) const
+{
+	ofstream outputFile(fileName, ios::out | ios::binary | ios::trunc);
+	if (!outputFile)
+	{
+		throw runtime_error("Could not open the file.");
+	}
+
+	write(outputFile);
+
+	if (!outputFile)
+	{
+		throw runtime_error("Could not write the file.");
+	}
+}
+
+void GraphGenerator::build(Graph& g, const unsigned threadCount) const
+{
+	// goes through the text format, so the graph is checked and built exactly
+	// as if it had been written to a file and read back
+
+	ostringstream text;
+	write(text);
+	g.readText(text.str(), threadCount);
+}
+
+bool GraphGenerator::shapeFromName(const string& name, Shape& shape)
+{
+	if (name == "grid")
+	{
+		shape = GRID;
+	}
+	else if (name == "geometric")
+	{
+		shape = GEOMETRIC;
+	}
+	else if (name == "road")
+	{
+		shape = ROAD;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+double GraphGenerator::nextUnit()
+{
+	// a uniform number in [0, 1). The standard distributions are not the same
+	// from one library to the next, so it is made from the generator's bits
+	return double(random() >> 5) * (1.0 / 134217728.0);
+}
+
+void GraphGenerator::placeNode(const double x, const double y)
+{
+	const double latitude = ORIGIN_LATITUDE + y / KM_PER_DEGREE;
+	const double longitude = ORIGIN_LONGITUDE + x / (KM_PER_DEGREE * cos(TO_RAD * ORIGIN_LATITUDE));
+	latitudes.push_back(float(latitude));
+	longitudes.push_back(float(longitude));
+}
+
+void GraphGenerator::addRoad(const nodeIndex from, const nodeIndex to, const double minFactor, const double factorRange,
+	const bool oneWay, const uint32_t name)
+{
+	// the cost is the straight line distance, measured between the float
+	// coordinates as the heuristics measure it, times a factor of at least one
+
+	const float length = Node(latitudes[from], longitudes[from]).linearDistanceTo(Node(latitudes[to], longitudes[to]));
+	const float cost = max(length, float(length * (minFactor + factorRange * nextUnit())));
+
+	GeneratedEdge edge = { from, to, cost, name };
+	edges.push_back(edge);
+	if (!oneWay)
+	{
+		swap(edge.tail, edge.head);
+		edges.push_back(edge);
+	}
+}
+
+void GraphGenerator::makeGrid(const nodeIndex count, const bool roadLike)
+{
+	// the nodes fill the rows of a square grid in turn, so the last row may be short
+
+	const nodeIndex width = nodeIndex(ceil(sqrt(double(count))));
+	const nodeIndex height = (count + width - 1) / width;
+
+	for (nodeIndex row = 0; row < height; ++row)
+	{
+		edgeNames.push_back("Row " + to_string(row));
+	}
+	for (nodeIndex column = 0; column < width; ++column)
+	{
+		edgeNames.push_back("Column " + to_string(column));
+	}
+
+	for (nodeIndex i = 0; i < count; ++i)
+	{
+		double x = double(i % width);
+		double y = double(i / width);
+		if (roadLike)
+		{
+			x += ROAD_JITTER * (2.0 * nextUnit() - 1.0);
+			y += ROAD_JITTER * (2.0 * nextUnit() - 1.0);
+		}
+		placeNode(x, y);
+	}
+
+	// join each node to the next one along its row and its column
+	for (nodeIndex i = 0; i < count; ++i)
+	{
+		const nodeIndex row = i / width;
+		const nodeIndex column = i % width;
+
+		for (int direction = 0; direction < 2; ++direction)
+		{
+			const bool alongRow = (direction == 0);
+			if (alongRow ? (column + 1 == width || i + 1 == count) : (i + width >= count))
+			{
+				continue;
+			}
+			const nodeIndex next = alongRow ? i + 1 : i + width;
+			const uint32_t name = alongRow ? row : height + column;
+
+			if (!roadLike)
+			{
+				addRoad(i, next, 1.0, 0.3, false, name);
+			}
+			else if ((alongRow ? row : column) % ARTERIAL_SPACING == 0)
+			{
+				addRoad(i, next, 1.0, 0.05, false, name);
+			}
+			else if (nextUnit() >= MISSING_STREETS)
+			{
+				const bool oneWay = (nextUnit() < ONE_WAY_STREETS);
+				if (oneWay && nextUnit() < 0.5)
+				{
+					addRoad(next, i, 1.2, 0.4, true, name);
+				}
+				else
+				{
+					addRoad(i, next, 1.2, 0.4, oneWay, name);
+				}
+			}
+		}
+	}
+}
+
+void GraphGenerator::makeGeometric(const nodeIndex count)
+{
+	// the nodes are scattered over a square of one node per square km, and
+	// sorted into cells of about that size, so the nearest neighbours of a
+	// node are found in the few cells around its own
+
+	const double side = sqrt(double(count));
+	const nodeIndex cellsPerSide = max<nodeIndex>(1, nodeIndex(side));
+	const double cellSize = side / cellsPerSide;
+
+	vector<double> xs(count), ys(count);
+	vector<nodeIndex> cellOf(count);
+	vector<nodeIndex> cellOffset(size_t(cellsPerSide) * cellsPerSide + 1, 0);
+	for (nodeIndex i = 0; i < count; ++i)
+	{
+		xs[i] = side * nextUnit();
+		ys[i] = side * nextUnit();
+		placeNode(xs[i], ys[i]);
+
+		const nodeIndex cx = min(cellsPerSide - 1, nodeIndex(xs[i] / cellSize));
+		const nodeIndex cy = min(cellsPerSide - 1, nodeIndex(ys[i] / cellSize));
+		cellOf[i] = cy * cellsPerSide + cx;
+		++cellOffset[cellOf[i] + 1];
+	}
+
+	for (size_t c = 1; c < cellOffset.size(); ++c)
+	{
+		cellOffset[c] += cellOffset[c - 1];
+	}
+	vector<nodeIndex> cellNodes(count);
+	vector<nodeIndex> fill(cellOffset.begin(), cellOffset.end() - 1);
+	for (nodeIndex i = 0; i < count; ++i)
+	{
+		cellNodes[fill[cellOf[i]]++] = i;
+	}
+
+	// find each node's neighbours in a growing block of cells, until the block
+	// holds enough of them, and no node outside it could be nearer
+	vector<pair<nodeIndex, nodeIndex> > links;
+	vector<pair<double, nodeIndex> > candidates;
+	for (nodeIndex i = 0; i < count; ++i)
+	{
+		const int cx = int(cellOf[i] % cellsPerSide);
+		const int cy = int(cellOf[i] / cellsPerSide);
+
+		for (int radius = 1; ; ++radius)
+		{
+			candidates.clear();
+			for (int y = max(0, cy - radius); y <= min(int(cellsPerSide) - 1, cy + radius); ++y)
+			{
+				for (int x = max(0, cx - radius); x <= min(int(cellsPerSide) - 1, cx + radius); ++x)
+				{
+					const nodeIndex cell = nodeIndex(y) * cellsPerSide + nodeIndex(x);
+					for (nodeIndex c = cellOffset[cell]; c < cellOffset[cell + 1]; ++c)
+					{
+						const nodeIndex n = cellNodes[c];
+						if (n != i)
+						{
+							const double dx = xs[n] - xs[i];
+							const double dy = ys[n] - ys[i];
+							candidates.push_back(make_pair(dx * dx + dy * dy, n));
+						}
+					}
+				}
+			}
+
+			const size_t k = min(NEIGHBOUR_COUNT, candidates.size());
+			partial_sort(candidates.begin(), candidates.begin() + k, candidates.end());
+
+			const double reach = radius * cellSize;
+			const bool covered = (radius >= int(cellsPerSide));
+			if (covered || (k == NEIGHBOUR_COUNT && candidates[k - 1].first <= reach * reach))
+			{
+				for (size_t j = 0; j < k; ++j)
+				{
+					links.push_back(make_pair(min(i, candidates[j].second), max(i, candidates[j].second)));
+				}
+				break;
+			}
+		}
+	}
+
+	// a pair of nodes that are each other's neighbours is joined once
+	sort(links.begin(), links.end());
+	links.erase(unique(links.begin(), links.end()), links.end());
+
+	edgeNames.push_back("Link");
+	for (vector<pair<nodeIndex, nodeIndex> >::const_iterator it = links.cbegin(); it != links.cend(); ++it)
+	{
+		addRoad(it->first, it->second, 1.0, 0.3, false, 0);
+	}
+}
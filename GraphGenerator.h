@@ -0,0 +1,90 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * GraphGenerator.h
+ */
+
+#ifndef GRAPH_GENERATOR_H
+#define GRAPH_GENERATOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "GraphTypes.h"
+#include "Graph.h"
+
+using std::vector;
+
+
+// ---------------------------------------------------------------------------------/
+// The GraphGenerator class makes synthetic map graphs of any size, for testing		/
+// and benchmarking the searches on more than the sample maps. The nodes are laid	/
+// out about a kilometre apart, around 40N 100W.									/
+//																					/
+//		GRID		:	a square grid, each node joined both ways to the nodes		/
+//						on its left, right, above and below.						/
+//		GEOMETRIC	:	nodes scattered at random, each joined both ways to its		/
+//						nearest neighbours.											/
+//		ROAD		:	a road-like planar network: a grid with the nodes moved		/
+//						off their places, some of its streets missing and some		/
+//						one-way, and every eighth row and column a faster			/
+//						arterial road.												/
+//																					/
+// An edge costs its straight line length times a random factor of at least one,	/
+// so the distance heuristics stay admissible. The graph depends only on the		/
+// shape, the node count and the seed, on any platform, so a benchmark run on a		/
+// generated graph can be repeated exactly. The graph is written out in the text	/
+// format read by Graph::readFile(), or built straight into a Graph in memory.		/
+// ---------------------------------------------------------------------------------/
+
+class GraphGenerator
+{
+public:
+
+	// Enum for the shape of the graph
+	//
+	enum Shape { GRID, GEOMETRIC, ROAD };
+
+	// Constructor, which generates the graph
+	//
+
+	GraphGenerator(const Shape, const nodeIndex, const std::uint32_t = 1);
+
+	// public utility functions
+	//
+
+	nodeIndex nodeCount() const;
+	edgeIndex edgeCount() const;
+	void write(std::ostream&) const;
+	void writeFile(const std::string&) const;
+	void build(Graph&, const unsigned = 0) const;
+	static bool shapeFromName(const std::string&, Shape&);
+
+private:
+	struct GeneratedEdge
+	{
+		nodeIndex tail;
+		nodeIndex head;
+		float cost;
+		std::uint32_t name;
+	};
+
+	vector<float> latitudes;
+	vector<float> longitudes;
+	vector<GeneratedEdge> edges;
+	vector<std::string> edgeNames;
+	std::mt19937 random;
+
+	// private utility functions
+	//
+
+	double nextUnit();
+	void placeNode(const double, const double);
+	void addRoad(const nodeIndex, const nodeIndex, const double, const double, const bool, const std::uint32_t);
+	void makeGrid(const nodeIndex, const bool);
+	void makeGeometric(const nodeIndex);
+};
+
+#endif /* GRAPH_GENERATOR_H */
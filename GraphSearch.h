@@ -0,0 +1,281 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * GraphSearch.h
+ */
+
+#ifndef GRAPH_SEARCH_H
+#define GRAPH_SEARCH_H
+
+#include <vector>
+#include "SearchBase.h"
+#include "Frontier.h"
+#include "Heuristic.h"
+#include "Landmarks.h"
+#include "DistanceKernel.h"
+
+
+using namespace std;
+
+// ---------------------------------------------------------------------------------/
+// The GraphSearch class template is the one directional best first graph search	/
+// that UniformCostSearch, BestFirstSearch and AStarSearch are made from. It		/
+// takes the node with the smallest key from the frontier, and relaxes its edges,	/
+// until it takes the goal. What differs from one search to another is given by		/
+// two policies, fixed at compile time, so their calls are inlined into the			/
+// relaxation loop rather than dispatched at run time:								/
+//																					/
+//		Estimate	:	the estimated distance to the goal of the heads of a		/
+//						node's edges, filled in a block at a time by fill(), or		/
+//						nothing at all when EVALUATES is false.						/
+//		Priority	:	the key of a node from its path cost and its estimate,		/
+//						by key(), and whether a node explored already is put		/
+//						back in the frontier when a shorter path to it is found		/
+//						(REOPENS), as a heuristic that is not consistent needs.		/
+//																					/
+// The policies below cover the existing searches, plus weighted A* and A* with		/
+// Landmarks called directly; any other class with the same members will do.		/
+// ---------------------------------------------------------------------------------/
+
+// no estimate, for uniform cost search
+struct NoEstimate
+{
+	static constexpr bool EVALUATES = false;
+
+	void setTarget(const nodeIndex) {}
+	void fill(const Graph&, const nodeIndex, float*) const {}
+};
+
+// the straight line distance to the goal
+struct DistanceEstimate
+{
+	static constexpr bool EVALUATES = true;
+
+	DistanceKernel distance;
+
+	explicit DistanceEstimate(const Graph& g, const DistanceKernel::Mode mode = DistanceKernel::HAVERSINE) : distance(g, mode) {}
+
+	void setTarget(const nodeIndex goal) { distance.setTarget(goal); }
+	void fill(const Graph& g, const nodeIndex n, float* estimates) const
+	{
+		distance.fill(g.edgeHeadBlock(n), g.edgesEnd(n) - g.edgesBegin(n), estimates);
+	}
+};
+
+// the landmark bounds, called without going through the Heuristic interface
+struct LandmarkEstimate
+{
+	static constexpr bool EVALUATES = true;
+
+	const Landmarks& landmarks;
+	nodeIndex goal;
+
+	explicit LandmarkEstimate(const Landmarks& l) : landmarks(l), goal(INVALID_NODE) {}
+
+	void setTarget(const nodeIndex target) { goal = target; }
+	void fill(const Graph& g, const nodeIndex n, float* estimates) const
+	{
+		for (edgeIndex e = g.edgesBegin(n); e != g.edgesEnd(n); ++e)
+		{
+			*estimates++ = landmarks.estimate(g.edgeHead(e), goal);
+		}
+	}
+};
+
+// any Heuristic if given one, or else the straight line distance. The choice is
+// made once per node, outside the relaxation loop
+struct GuidedEstimate
+{
+	static constexpr bool EVALUATES = true;
+
+	const Heuristic* guide;
+	DistanceEstimate straightLine;
+	nodeIndex goal;
+
+	GuidedEstimate(const Graph& g, const Heuristic* h, const DistanceKernel::Mode mode = DistanceKernel::HAVERSINE)
+		: guide(h), straightLine(g, mode), goal(INVALID_NODE) {}
+
+	void setTarget(const nodeIndex target) { goal = target; straightLine.setTarget(target); }
+	void fill(const Graph& g, const nodeIndex n, float* estimates) const
+	{
+		if (!guide)
+		{
+			straightLine.fill(g, n, estimates);
+			return;
+		}
+		for (edgeIndex e = g.edgesBegin(n); e != g.edgesEnd(n); ++e)
+		{
+			*estimates++ = guide->estimate(g.edgeHead(e), goal);
+		}
+	}
+};
+
+// the path cost, for uniform cost search
+struct CostPriority
+{
+	static constexpr bool REOPENS = false;
+	float key(const float cost, const float) const { return cost; }
+};
+
+// the estimate alone, for greedy best first search
+struct EstimatePriority
+{
+	static constexpr bool REOPENS = false;
+	float key(const float, const float estimate) const { return estimate; }
+};
+
+// the path cost plus the estimate, for A*
+struct SumPriority
+{
+	static constexpr bool REOPENS = true;
+	float key(const float cost, const float estimate) const { return cost + estimate; }
+};
+
+// the path cost plus the estimate times a weight of one or more, for weighted
+// A*, which settles fewer nodes but can find a route up to weight times too long
+struct WeightedSumPriority
+{
+	static constexpr bool REOPENS = true;
+
+	float weight;
+
+	explicit WeightedSumPriority(const float w) : weight(w) {}
+	float key(const float cost, const float estimate) const { return cost + weight * estimate; }
+};
+
+template <class Estimate, class Priority>
+class GraphSearch : public SearchBase
+{
+public:
+
+	// Constructor
+	//
+
+	GraphSearch(const Graph& g, const Estimate& e, const Priority& p = Priority(), const Frontier::Type frontierType = Frontier::D_ARY_HEAP)
+		: SearchBase(g), frontier(frontierType), estimate(e), priority(p)
+	{
+		// empty constructor
+	}
+
+	// public utility functions
+	//
+
+	virtual SearchStatus processNext();
+
+protected:
+	virtual void start();
+	virtual void collectStats();
+
+private:
+	Frontier frontier;
+	Estimate estimate;
+	Priority priority;
+
+	// the estimates of the children of the node being expanded
+	vector<float> estimates;
+};
+
+template <class Estimate, class Priority>
+void GraphSearch<Estimate, Priority>::start()
+{
+	// put initial node in the frontier, with cost:0 and status:frontier
+	context.prepare(graph.nodeCount());
+	frontier.prepare(graph.nodeCount());
+	context.stateAt(initialNode).setStatus(NodeState::FRONTIER);
+	context.stateAt(initialNode).setPathCost(0.0f);
+	frontier.push(initialNode, 0.0f);
+
+	// the estimates are all to the goal
+	estimate.setTarget(goalNode);
+}
+
+template <class Estimate, class Priority>
+void GraphSearch<Estimate, Priority>::collectStats()
+{
+	stats.addFrontier(frontier);
+}
+
+template <class Estimate, class Priority>
+SearchStatus GraphSearch<Estimate, Priority>::processNext()
+{
+	// if the frontier is empty and goal is not found, return failure
+	if (frontier.empty())
+		return SearchStatus::FAILURE;
+
+	// take a node from frontier, and set to explored
+	nodeIndex currentNode = frontier.pop();
+	NodeState& current = context.stateAt(currentNode);
+	current.setStatus(NodeState::EXPLORED);
+
+	// check if current node is the goal
+	if (currentNode == goalNode)
+	{
+		// empty the frontier so it is ready for the next search
+		frontier.clear();
+		return SearchStatus::SUCCESS;
+	}
+
+	// if the current node is not the goal, then find it's children and add them to the frontier
+	// we only add nodes not already expanded or in the frontier (graph search), and update nodes
+	// if shorter paths are found
+	const edgeIndex firstEdge = graph.edgesBegin(currentNode);
+	const edgeIndex childCount = graph.edgesEnd(currentNode) - firstEdge;
+	stats.edgesRelaxed += childCount;
+
+	// estimate the distance to the goal of all the children at once
+	if (Estimate::EVALUATES)
+	{
+		estimates.resize(childCount);
+		stats.heuristicEvaluations += childCount;
+		estimate.fill(graph, currentNode, estimates.data());
+	}
+
+	for( edgeIndex edge = firstEdge; edge != firstEdge + childCount; ++edge)
+	{
+		nodeIndex childNode = graph.edgeHead(edge);
+		NodeState& child = context.stateAt(childNode);
+		float newNodeCost = current.getPathCost() + edgeCost(edge);
+		float key = priority.key(newNodeCost, Estimate::EVALUATES ? estimates[edge - firstEdge] : 0.0f);
+
+		// if the generated child node is unexplored (not in the frontier, and not explored),
+		// update the child node's state and put it in the frontier
+		if (child.getStatus() == NodeState::UNEXPLORED)
+		{
+			// set status to frontier, update cost, set parent node and action, then add to frontier
+			child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, edge);
+			if (Estimate::EVALUATES)
+			{
+				child.setHeuristic(key);
+			}
+			frontier.push(childNode, key);
+		}
+
+		// if the generated child node is in the frontier, and we found a SHORTER path, then
+		// update the child node's state, and lower its key in place so the frontier
+		// moves it forward to its new position
+		else if (child.getStatus() == NodeState::FRONTIER && newNodeCost < child.getPathCost())
+		{
+			child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, edge);
+			if (Estimate::EVALUATES)
+			{
+				child.setHeuristic(key);
+			}
+			frontier.decreaseKey(childNode, key);
+		}
+
+		// if the child was already explored but we found a SHORTER path, which an
+		// admissible heuristic that is not quite consistent can lead to, then
+		// put it back in the frontier so the shorter path is followed on
+		else if (Priority::REOPENS && child.getStatus() == NodeState::EXPLORED && newNodeCost < child.getPathCost())
+		{
+			child.setSearchState(NodeState::FRONTIER, newNodeCost, currentNode, edge);
+			child.setHeuristic(key);
+			frontier.push(childNode, key);
+		}
+	}
+
+	// Return that we are still searching
+	return SearchStatus::SEARCHING;
+}
+
+#endif /* GRAPH_SEARCH_H */
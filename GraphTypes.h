@@ -0,0 +1,33 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * GraphTypes.h
+ */
+
+#ifndef GRAPH_TYPES_H
+#define GRAPH_TYPES_H
+
+#include <cstdint>
+
+
+// ---------------------------------------------------------------------------------/
+// Index types shared by the Graph and the search classes.							/
+// Nodes and edges are addressed by their position in the Graph's arrays, which		/
+// keeps every reference 32 bits wide instead of a pointer plus control block.		/
+//																					/
+// A fixedCost is an edge or route cost as a whole number of small units, see		/
+// FixedCosts. Unlike a float it sums exactly, and is its own key in a radix		/
+// queue.																			/
+// ---------------------------------------------------------------------------------/
+
+typedef std::uint32_t nodeIndex;
+typedef std::uint32_t edgeIndex;
+
+const nodeIndex INVALID_NODE = 0xFFFFFFFFu;
+const edgeIndex INVALID_EDGE = 0xFFFFFFFFu;
+
+typedef std::uint32_t fixedCost;
+
+const fixedCost INFINITE_FIXED_COST = 0xFFFFFFFFu;
+
+#endif /* GRAPH_TYPES_H */
@@ -0,0 +1,39 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * Heuristic.h
+ */
+
+#ifndef HEURISTIC_H
+#define HEURISTIC_H
+
+#include "GraphTypes.h"
+
+
+// ---------------------------------------------------------------------------------/
+// The Heuristic class is the interface of a lower bound on the cost of the			/
+// shortest route between two nodes, used to guide AStarSearch towards the goal.	/
+// The estimate must never be more than the true cost, or A* can return a longer	/
+// route, and should be consistent (it never drops by more than the cost of an		/
+// edge), or A* can expand a node before its shortest path is known.				/
+//																					/
+// Estimates are read by every search using the heuristic, on any number of			/
+// threads, so a heuristic keeps no per-query state.								/
+// ---------------------------------------------------------------------------------/
+
+class Heuristic
+{
+public:
+
+	// Destructor
+	//
+
+	virtual ~Heuristic() {}
+
+	// public utility functions
+	//
+
+	virtual float estimate(const nodeIndex, const nodeIndex) const = 0;
+};
+
+#endif /* HEURISTIC_H */
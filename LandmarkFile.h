@@ -0,0 +1,50 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * LandmarkFile.h
+ */
+
+#ifndef LANDMARK_FILE_H
+#define LANDMARK_FILE_H
+
+#include <cstdint>
+
+
+// ---------------------------------------------------------------------------------/
+// Layout of the landmark file, written by Landmarks::writeFile() and mapped into	/
+// memory by Landmarks::readFile().													/
+//																					/
+// The file starts with a LandmarkFileHeader, followed by one section per array		/
+// of the Landmarks, aligned and laid out the same way as the sections of a			/
+// binary graph file (see GraphFile.h). The tables are only valid for the graph		/
+// they were computed on, so the header records its node and edge counts and a		/
+// checksum of its edges, and a reader rejects the file for any other graph.		/
+// ---------------------------------------------------------------------------------/
+
+const char LANDMARK_FILE_MAGIC[8] = { 'G', 'M', 'S', 'L', 'M', 'A', 'R', 'K' };
+const std::uint32_t LANDMARK_FILE_VERSION = 1;
+const std::uint32_t LANDMARK_FILE_BYTE_ORDER = 0x01020304u;
+const std::uint64_t LANDMARK_FILE_ALIGNMENT = 64;
+
+enum LandmarkFileSection
+{
+	SECTION_LANDMARK_NODE,			// nodeIndex per landmark
+	SECTION_LANDMARK_FROM,			// float per node, per landmark
+	SECTION_LANDMARK_TO,			// float per node, per landmark
+	LANDMARK_SECTION_COUNT
+};
+
+struct LandmarkFileHeader
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t byteOrder;
+	std::uint32_t nodeCount;
+	std::uint32_t edgeCount;
+	std::uint32_t landmarkCount;
+	std::uint32_t graphChecksum;
+	std::uint64_t sectionOffset[LANDMARK_SECTION_COUNT];
+	std::uint64_t sectionSize[LANDMARK_SECTION_COUNT];
+};
+
+#endif /* LANDMARK_FILE_H */
@@ -0,0 +1,348 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * Landmarks.cpp
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "Landmarks.h"
+#include "LandmarkFile.h"
+#include "Frontier.h"
+#include "ThreadPool.h"
+
+using namespace boost;
+
+static const float UNREACHABLE = numeric_limits<float>::infinity();
+
+Landmarks::Landmarks()
+{
+	clear();
+}
+
+void Landmarks::build(const Graph& g, const unsigned requested)
+{
+	// picks the landmarks farthest first, and fills in their tables as it goes.
+	// The first landmark is the node farthest from node 0, after that each one
+	// is the node farthest from the landmarks already chosen, where the distance
+	// to a landmark is the cost of the round trip to it and back
+
+	clear();
+
+	const nodeIndex n = g.nodeCount();
+	const unsigned k = unsigned(min<size_t>(requested, n));
+	graphNodes = n;
+	graphEdges = g.edgeCount();
+	graphChecksum = checksum(g);
+	if (k == 0)
+	{
+		return;
+	}
+
+	vector<nodeIndex> landmarks;
+	vector<float> from(size_t(n) * k);
+	vector<float> to(size_t(n) * k);
+	vector<float> forward;
+	vector<float> backward;
+	vector<float> separation(n);
+	vector<std::uint8_t> isLandmark(n, 0);
+
+	// the two directions of each landmark are independent, so run them together
+	ThreadPool pool(2);
+	nodeIndex source = 0;
+
+	for (unsigned i = 0; i <= k; ++i)
+	{
+		pool.submit([&g, source, &forward]() { shortestCosts(g, source, false, forward); });
+		pool.submit([&g, source, &backward]() { shortestCosts(g, source, true, backward); });
+		pool.wait();
+
+		for (nodeIndex v = 0; v < n; ++v)
+		{
+			// node 0 only seeds the choice of the first landmark, it is not one itself
+			const float roundTrip = forward[v] + backward[v];
+			separation[v] = (i <= 1) ? roundTrip : min(separation[v], roundTrip);
+			if (i > 0)
+			{
+				from[size_t(v) * k + i - 1] = forward[v];
+				to[size_t(v) * k + i - 1] = backward[v];
+			}
+		}
+		if (i == k)
+		{
+			break;
+		}
+
+		// the farthest node that is not a landmark yet. Nodes the landmarks cannot
+		// reach, or cannot be reached from, are infinitely far, and picked first
+		source = INVALID_NODE;
+		for (nodeIndex v = 0; v < n; ++v)
+		{
+			if (!isLandmark[v] && (source == INVALID_NODE || separation[v] > separation[source]))
+			{
+				source = v;
+			}
+		}
+		isLandmark[source] = 1;
+		landmarks.push_back(source);
+	}
+
+	landmarkCount = k;
+	landmarkList.adopt(landmarks);
+	fromLandmark.adopt(from);
+	toLandmark.adopt(to);
+}
+
+void Landmarks::readFile(const string& fileName, const Graph& g)
+{
+	// maps a landmark file, written by writeFile(), into memory and points the
+	// tables at its sections, as Graph::readBinaryFile() does for a graph.
+	// The file must have been computed on this graph, or its estimates would
+	// not be lower bounds, so anything else is rejected
+
+	boost::shared_ptr<interprocess::mapped_region> region;
+	try
+	{
+		interprocess::file_mapping file(fileName.c_str(), interprocess::read_only);
+		region.reset(new interprocess::mapped_region(file, interprocess::read_only));
+	}
+	catch (interprocess::interprocess_exception&)
+	{
+		throw runtime_error("Could not open the file.");
+	}
+
+	const char* base = static_cast<const char*>(region->get_address());
+	const uint64_t fileSize = region->get_size();
+
+	LandmarkFileHeader header;
+	if (fileSize < sizeof(header))
+	{
+		throw runtime_error("File format error : Landmark file is truncated");
+	}
+	memcpy(&header, base, sizeof(header));
+
+	if (memcmp(header.magic, LANDMARK_FILE_MAGIC, sizeof(header.magic)) != 0)
+	{
+		throw runtime_error("File format error : Not a landmark file");
+	}
+	if (header.byteOrder != LANDMARK_FILE_BYTE_ORDER)
+	{
+		throw runtime_error("File format error : Landmark file has the wrong byte order");
+	}
+	if (header.version != LANDMARK_FILE_VERSION)
+	{
+		throw runtime_error("File format error : Unsupported landmark file version");
+	}
+	if (header.nodeCount != g.nodeCount() || header.edgeCount != g.edgeCount() || header.graphChecksum != checksum(g) ||
+		header.landmarkCount > header.nodeCount)
+	{
+		throw runtime_error("File format error : Landmark file was computed for a different graph");
+	}
+
+	const uint64_t k = header.landmarkCount;
+	const uint64_t elementCount[LANDMARK_SECTION_COUNT] = { k, k * header.nodeCount, k * header.nodeCount };
+
+	for (int s = 0; s < LANDMARK_SECTION_COUNT; ++s)
+	{
+		const uint64_t offset = header.sectionOffset[s];
+		const uint64_t size = header.sectionSize[s];
+		if (offset % LANDMARK_FILE_ALIGNMENT != 0 || offset > fileSize || size > fileSize - offset || size != elementCount[s] * 4)
+		{
+			throw runtime_error("File format error : Landmark file section is corrupt");
+		}
+	}
+
+	const nodeIndex* landmarks = reinterpret_cast<const nodeIndex*>(base + header.sectionOffset[SECTION_LANDMARK_NODE]);
+	for (uint64_t i = 0; i < k; ++i)
+	{
+		if (landmarks[i] >= header.nodeCount)
+		{
+			throw runtime_error("File format error : Landmark file section is corrupt");
+		}
+	}
+
+	clear();
+	mappedFile = region;
+
+	landmarkCount = unsigned(k);
+	graphNodes = header.nodeCount;
+	graphEdges = header.edgeCount;
+	graphChecksum = header.graphChecksum;
+	landmarkList.attach(landmarks, k);
+	fromLandmark.attach(reinterpret_cast<const float*>(base + header.sectionOffset[SECTION_LANDMARK_FROM]), elementCount[SECTION_LANDMARK_FROM]);
+	toLandmark.attach(reinterpret_cast<const float*>(base + header.sectionOffset[SECTION_LANDMARK_TO]), elementCount[SECTION_LANDMARK_TO]);
+}
+
+void Landmarks::writeFile(const string& fileName) const
+{
+	// writes the tables in the format described in LandmarkFile.h, so they
+	// can later be loaded with readFile()
+
+	ofstream outputFile(fileName, ios::out | ios::binary | ios::trunc);
+	if (!outputFile)
+	{
+		throw runtime_error("Could not open the file.");
+	}
+
+	const void* sectionData[LANDMARK_SECTION_COUNT] = { landmarkList.data(), fromLandmark.data(), toLandmark.data() };
+
+	LandmarkFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, LANDMARK_FILE_MAGIC, sizeof(header.magic));
+	header.version = LANDMARK_FILE_VERSION;
+	header.byteOrder = LANDMARK_FILE_BYTE_ORDER;
+	header.nodeCount = graphNodes;
+	header.edgeCount = graphEdges;
+	header.landmarkCount = landmarkCount;
+	header.graphChecksum = graphChecksum;
+	header.sectionSize[SECTION_LANDMARK_NODE] = landmarkList.size() * sizeof(nodeIndex);
+	header.sectionSize[SECTION_LANDMARK_FROM] = fromLandmark.size() * sizeof(float);
+	header.sectionSize[SECTION_LANDMARK_TO] = toLandmark.size() * sizeof(float);
+
+	// lay the sections out one after the other, each on an aligned offset
+	uint64_t offset = sizeof(header);
+	for (int s = 0; s < LANDMARK_SECTION_COUNT; ++s)
+	{
+		offset = (offset + LANDMARK_FILE_ALIGNMENT - 1) / LANDMARK_FILE_ALIGNMENT * LANDMARK_FILE_ALIGNMENT;
+		header.sectionOffset[s] = offset;
+		offset += header.sectionSize[s];
+	}
+
+	outputFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	const char padding[LANDMARK_FILE_ALIGNMENT] = { 0 };
+	uint64_t written = sizeof(header);
+	for (int s = 0; s < LANDMARK_SECTION_COUNT; ++s)
+	{
+		outputFile.write(padding, streamsize(header.sectionOffset[s] - written));
+		outputFile.write(static_cast<const char*>(sectionData[s]), streamsize(header.sectionSize[s]));
+		written = header.sectionOffset[s] + header.sectionSize[s];
+	}
+
+	if (!outputFile)
+	{
+		throw runtime_error("Could not write the file.");
+	}
+}
+
+bool Landmarks::isLandmarkFile(const string& fileName)
+{
+	// checks whether a file exists and starts with the landmark file magic
+
+	ifstream inputFile(fileName, ios::in | ios::binary);
+	char magic[sizeof(LANDMARK_FILE_MAGIC)];
+	if (!inputFile.read(magic, sizeof(magic)))
+	{
+		return false;
+	}
+	return memcmp(magic, LANDMARK_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+float Landmarks::estimate(const nodeIndex n, const nodeIndex goal) const
+{
+	// the largest triangle inequality bound over all landmarks. A bound is only
+	// taken when the landmark reaches the node (or the goal reaches the landmark);
+	// if it then misses the other one, the goal cannot be reached from the node
+	// and the bound is infinite
+
+	const float* fromNode = fromLandmark.data() + size_t(n) * landmarkCount;
+	const float* fromGoal = fromLandmark.data() + size_t(goal) * landmarkCount;
+	const float* toNode = toLandmark.data() + size_t(n) * landmarkCount;
+	const float* toGoal = toLandmark.data() + size_t(goal) * landmarkCount;
+
+	float bound = 0.0f;
+	for (unsigned i = 0; i < landmarkCount; ++i)
+	{
+		if (fromNode[i] != UNREACHABLE)
+		{
+			bound = max(bound, fromGoal[i] - fromNode[i]);
+		}
+		if (toGoal[i] != UNREACHABLE)
+		{
+			bound = max(bound, toNode[i] - toGoal[i]);
+		}
+	}
+	return bound;
+}
+
+void Landmarks::clear()
+{
+	// empties the tables, releasing any mapped file
+
+	landmarkCount = 0;
+	graphNodes = 0;
+	graphEdges = 0;
+	graphChecksum = 0;
+	landmarkList.clear();
+	fromLandmark.clear();
+	toLandmark.clear();
+	mappedFile.reset();
+}
+
+uint32_t Landmarks::checksum(const Graph& g)
+{
+	// 32 bit FNV-1a over the tail, head and cost of every edge, which is
+	// everything the costs in the tables depend on
+
+	uint32_t h = 2166136261u;
+	for (edgeIndex e = 0; e < g.edgeCount(); ++e)
+	{
+		const float cost = g.edgeCost(e);
+		uint32_t words[3] = { g.edgeTail(e), g.edgeHead(e), 0 };
+		memcpy(&words[2], &cost, sizeof(cost));
+
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(words);
+		for (size_t i = 0; i < sizeof(words); ++i)
+		{
+			h ^= bytes[i];
+			h *= 16777619u;
+		}
+	}
+	return h;
+}
+
+void Landmarks::shortestCosts(const Graph& g, const nodeIndex source, const bool reverse, vector<float>& costs)
+{
+	// uniform cost search from the source to every node, over the edges entering
+	// each node when reverse is set, which gives the costs to the source instead
+
+	costs.assign(g.nodeCount(), UNREACHABLE);
+	Frontier frontier;
+	frontier.prepare(g.nodeCount());
+
+	costs[source] = 0.0f;
+	frontier.push(source, 0.0f);
+
+	while (!frontier.empty())
+	{
+		const nodeIndex current = frontier.pop();
+		const edgeIndex begin = reverse ? g.inEdgesBegin(current) : g.edgesBegin(current);
+		const edgeIndex end = reverse ? g.inEdgesEnd(current) : g.edgesEnd(current);
+
+		for (edgeIndex i = begin; i != end; ++i)
+		{
+			const edgeIndex edge = reverse ? g.inEdge(i) : i;
+			const nodeIndex child = reverse ? g.edgeTail(edge) : g.edgeHead(edge);
+			const float cost = costs[current] + g.edgeCost(edge);
+
+			// a settled node already has its lowest cost, so only nodes that are
+			// new or still in the frontier can get here
+			if (cost < costs[child])
+			{
+				if (costs[child] == UNREACHABLE)
+				{
+					frontier.push(child, cost);
+				}
+				else
+				{
+					frontier.decreaseKey(child, cost);
+				}
+				costs[child] = cost;
+			}
+		}
+	}
+}
@@ -0,0 +1,93 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * Landmarks.h
+ */
+
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "GraphTypes.h"
+#include "MappedArray.h"
+#include "Heuristic.h"
+#include "Graph.h"
+
+using namespace std;
+
+namespace boost { namespace interprocess { class mapped_region; } }
+
+// ---------------------------------------------------------------------------------/
+// The Landmarks class is the ALT heuristic (A*, landmarks and the triangle			/
+// inequality). A few nodes are picked as landmarks, and the cost of the shortest	/
+// route from every landmark to every node, and from every node back to every		/
+// landmark, is computed once up front.												/
+//																					/
+// For any landmark L, the triangle inequality gives two lower bounds on the cost	/
+// from a node v to the goal t:  d(L,t) - d(L,v)  and  d(v,L) - d(t,L).				/
+// The estimate is the largest of these over all landmarks. Unlike the straight		/
+// line distance, the bounds follow the edge costs, so they stay tight when the		/
+// costs are travel times or winding road distances.								/
+//																					/
+// Landmarks are picked farthest first: each new landmark is the node whose round	/
+// trip to the nearest landmark chosen so far costs the most, which spreads them	/
+// around the edges of the map, where they give the best bounds.					/
+//																					/
+// The tables are laid out node by node, so an estimate reads two short rows.		/
+// They can be written to a landmark file (see LandmarkFile.h) and mapped back		/
+// in, like a binary graph file, instead of being computed on every start.			/
+// ---------------------------------------------------------------------------------/
+
+class Landmarks : public Heuristic
+{
+public:
+
+	static constexpr unsigned DEFAULT_COUNT = 16;
+
+	// Constructor
+	//
+
+	Landmarks();
+
+	// public utility functions
+	//
+
+	void build(const Graph&, const unsigned = DEFAULT_COUNT);
+	void readFile(const string&, const Graph&);
+	void writeFile(const string&) const;
+	static bool isLandmarkFile(const string&);
+
+	unsigned count() const { return landmarkCount; }
+	nodeIndex landmarkAt(const unsigned i) const { return landmarkList[i]; }
+
+	virtual float estimate(const nodeIndex, const nodeIndex) const final;
+
+private:
+	unsigned landmarkCount;
+
+	// the graph the tables were computed on
+	nodeIndex graphNodes;
+	edgeIndex graphEdges;
+	std::uint32_t graphChecksum;
+
+	// the landmarks, and the costs from each landmark to each node and back,
+	// at [node * landmarkCount + landmark]. Unreachable nodes are at infinity
+	MappedArray<nodeIndex> landmarkList;
+	MappedArray<float> fromLandmark;
+	MappedArray<float> toLandmark;
+
+	// the mapped landmark file the arrays point into, if any
+	boost::shared_ptr<boost::interprocess::mapped_region> mappedFile;
+
+	// private utility functions
+	//
+
+	void clear();
+	static std::uint32_t checksum(const Graph&);
+	static void shortestCosts(const Graph&, const nodeIndex, const bool, vector<float>&);
+};
+
+#endif /* LANDMARKS_H */
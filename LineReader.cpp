@@ -0,0 +1,46 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * LineReader.cpp
+ */
+
+#include <cstring>
+#include "LineReader.h"
+
+using namespace std;
+
+LineReader::LineReader(const char* begin, const char* rangeEnd) : next(begin), end(rangeEnd)
+{
+	// empty constructor
+}
+
+bool LineReader::nextLine(string_view& line)
+{
+	// finds the end of the next line, and moves past it.
+	// returns false once every line of the range has been handed out
+
+	if (next == end)
+	{
+		return false;
+	}
+
+	const char* begin = next;
+	const char* newline = static_cast<const char*>(memchr(begin, '\n', end - begin));
+	if (newline != 0)
+	{
+		next = newline + 1;
+	}
+	else
+	{
+		newline = end;
+		next = end;
+	}
+
+	size_t length = newline - begin;
+	if (length > 0 && begin[length - 1] == '\r')
+	{
+		--length;
+	}
+	line = string_view(begin, length);
+	return true;
+}
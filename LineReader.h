@@ -0,0 +1,43 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * LineReader.h
+ */
+
+#ifndef LINE_READER_H
+#define LINE_READER_H
+
+#include <string_view>
+
+using std::string_view;
+
+
+// ---------------------------------------------------------------------------------/
+// The LineReader class splits a range of text in memory, usually part of a mapped	/
+// file, into lines, and hands them out as views into the range, so reading a line	/
+// does not allocate or copy it.													/
+// Lines may end in "\n" or "\r\n"; the line ending is not part of the view. The	/
+// last line of the range need not end in a newline.								/
+// ---------------------------------------------------------------------------------/
+
+class LineReader
+{
+public:
+
+	// Constructor
+	//
+
+	LineReader(const char*, const char*);
+
+	// public utility functions
+	//
+
+	bool nextLine(string_view&);
+	const char* position() const { return next; }
+
+private:
+	const char* next;
+	const char* end;
+};
+
+#endif /* LINE_READER_H */
@@ -0,0 +1,150 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * MappedArray.h
+ */
+
+#ifndef MAPPED_ARRAY_H
+#define MAPPED_ARRAY_H
+
+#include <cstddef>
+#include <vector>
+
+using std::size_t;
+using std::vector;
+
+
+// ---------------------------------------------------------------------------------/
+// The MappedArray class is a read-mostly array that either owns its elements in	/
+// a vector, or views elements that live somewhere else, such as a section of a		/
+// memory-mapped graph file. Readers go through a plain pointer either way, so		/
+// the Graph's accessors cost the same whichever way the data was loaded.			/
+//																					/
+// The mutating functions copy viewed elements into owned storage first (copy on	/
+// write), so they are safe to call on a mapped array, but are meant for loading	/
+// rather than for the search loops.												/
+// ---------------------------------------------------------------------------------/
+
+template <typename T>
+class MappedArray
+{
+public:
+
+	// Constructors and assignment
+	// A copy of an owning array owns a copy of the elements, a copy of a
+	// viewing array views the same elements
+	//
+
+	MappedArray() : view(0), count(0) {}
+
+	MappedArray(const MappedArray& other) : owned(other.owned), view(other.view), count(other.count)
+	{
+		if (other.isOwned())
+		{
+			view = owned.data();
+		}
+	}
+
+	MappedArray& operator=(const MappedArray& other)
+	{
+		if (this != &other)
+		{
+			owned = other.owned;
+			view = other.isOwned() ? owned.data() : other.view;
+			count = other.count;
+		}
+		return *this;
+	}
+
+	// Read access, used by the search loops
+	//
+
+	const T& operator[](const size_t i) const { return view[i]; }
+	const T* data() const { return view; }
+	const T* begin() const { return view; }
+	const T* end() const { return view + count; }
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	bool isOwned() const { return view == owned.data(); }
+
+	// Loading
+	//
+
+	void adopt(vector<T>& elements)
+	{
+		// takes over the elements of the vector, leaving it empty
+		owned.clear();
+		owned.swap(elements);
+		sync();
+	}
+
+	void attach(const T* elements, const size_t n)
+	{
+		// views n elements owned by someone else, who must keep them alive
+		vector<T>().swap(owned);
+		view = elements;
+		count = n;
+	}
+
+	void assign(const size_t n, const T& value)
+	{
+		owned.assign(n, value);
+		sync();
+	}
+
+	void push_back(const T& value)
+	{
+		makeOwned();
+		owned.push_back(value);
+		sync();
+	}
+
+	template <typename Iterator>
+	void append(Iterator first, Iterator last)
+	{
+		makeOwned();
+		owned.insert(owned.end(), first, last);
+		sync();
+	}
+
+	void reserve(const size_t n)
+	{
+		makeOwned();
+		owned.reserve(n);
+		sync();
+	}
+
+	T& modify(const size_t i)
+	{
+		makeOwned();
+		return owned[i];
+	}
+
+	void clear()
+	{
+		vector<T>().swap(owned);
+		sync();
+	}
+
+private:
+	vector<T> owned;
+	const T* view;
+	size_t count;
+
+	void sync()
+	{
+		view = owned.data();
+		count = owned.size();
+	}
+
+	void makeOwned()
+	{
+		if (!isOwned())
+		{
+			owned.assign(view, view + count);
+			sync();
+		}
+	}
+};
+
+#endif /* MAPPED_ARRAY_H */
@@ -0,0 +1,90 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * NodeState.cpp
+ */
+
+#include "NodeState.h"
+
+NodeState::NodeState()
+{
+	clearSearchState();
+}
+
+void NodeState::setStatus(const NodeState::ExploredStatus s)
+{
+	status = s;
+}
+
+NodeState::ExploredStatus NodeState::getStatus() const
+{
+	return status;
+}
+
+void NodeState::setPathCost(const float c)
+{
+	if (c >= 0.0f)
+		pathCost = c;
+	else
+		pathCost = 0.0f;
+}
+
+float NodeState::getPathCost() const
+{
+	return pathCost;
+}
+
+void NodeState::setHeuristic(const float h)
+{
+	if (h >= 0.0f)
+		heuristic = h;
+	else
+		heuristic = 0.0f;
+}
+
+float NodeState::getHeuristic() const
+{
+	return heuristic;
+}
+
+void NodeState::setParentNode(const nodeIndex p)
+{
+	parentNode = p;
+}
+
+nodeIndex NodeState::getParentNode() const
+{
+	return parentNode;
+}
+
+void NodeState::setParentAction(const edgeIndex e)
+{
+	parentAction = e;
+}
+
+edgeIndex NodeState::getParentAction() const
+{
+	return parentAction;
+}
+
+void NodeState::setSearchState(const ExploredStatus status, const float cost, const nodeIndex parent, const edgeIndex action)
+{
+	// convenience method to set multiple values in a single call
+
+	setStatus(status);
+	setPathCost(cost);
+	setParentNode(parent);
+	setParentAction(action);
+}
+
+void NodeState::clearSearchState()
+{
+	// set all values back to initial states
+	setStatus(UNEXPLORED);
+	setPathCost(0.0f);
+	setHeuristic(0.0f);
+
+	// clear the parent indices to point to nothing
+	setParentNode(INVALID_NODE);
+	setParentAction(INVALID_EDGE);
+}
@@ -0,0 +1,69 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * NodeState.h
+ */
+
+#ifndef NODE_STATE_H
+#define NODE_STATE_H
+
+#include "GraphTypes.h"
+
+
+
+// ---------------------------------------------------------------------------------/
+// The NodeState class holds what a graph search knows about one node: whether it	/
+// is unexplored, in the frontier or explored, its path cost and heuristic, and		/
+// the parent node and edge (action) it was reached through.						/
+// It is kept apart from the Node, so that the node data can stay read-only, and	/
+// be mapped straight from a binary graph file.										/
+// ---------------------------------------------------------------------------------/
+
+class NodeState
+{
+public:
+
+	// Enum for node's status
+	//
+	enum ExploredStatus { UNEXPLORED, FRONTIER, EXPLORED };
+
+	// Constructor
+	//
+
+	NodeState();
+
+	// Setters and getters
+	//
+
+	void setStatus(const ExploredStatus);
+	ExploredStatus getStatus() const;
+
+	void setPathCost(const float);
+	float getPathCost() const;
+
+	void setHeuristic(const float);
+	float getHeuristic() const;
+
+	void setParentNode(const nodeIndex);
+	nodeIndex getParentNode() const;
+
+	void setParentAction(const edgeIndex);
+	edgeIndex getParentAction() const;
+
+	void setSearchState(const ExploredStatus, const float, const nodeIndex, const edgeIndex);
+
+	// Additional public utility functions
+	//
+
+	void clearSearchState();
+
+
+private:
+	ExploredStatus status;
+	float pathCost;
+	float heuristic;
+	nodeIndex parentNode;
+	edgeIndex parentAction;
+};
+
+#endif /* NODE_STATE_H */
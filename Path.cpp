@@ -0,0 +1,63 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * Path.cpp
+ */
+
+#include <limits>
+#include "Graph.h"
+#include "Path.h"
+
+using namespace std;
+
+Path::Path() : totalCost(numeric_limits<float>::infinity())
+{
+	// empty constructor
+}
+
+void Path::clear()
+{
+	// no route. The arrays keep their capacity for the next route
+	totalCost = numeric_limits<float>::infinity();
+	nodeList.clear();
+	edgeList.clear();
+}
+
+void Path::reset(const float cost, const size_t edges)
+{
+	// sizes the path for a route of the given number of edges, whose nodes
+	// and edges are then filled in by setStep() and setLastNode()
+	totalCost = cost;
+	nodeList.resize(edges + 1);
+	edgeList.resize(edges);
+}
+
+void Path::setStep(const size_t i, const nodeIndex from, const edgeIndex edge)
+{
+	// step i of the route leaves node from by edge
+	nodeList[i] = from;
+	edgeList[i] = edge;
+}
+
+void Path::setLastNode(const nodeIndex goal)
+{
+	nodeList.back() = goal;
+}
+
+void Path::print(const Graph& g, ostream& out) const
+{
+	// lists the route edge by edge, then its total cost
+
+	out << "\nResult\n------\n";
+
+	for (size_t i = 0; i < edgeList.size(); ++i)
+	{
+		Edge solnEdge = g.edgeAt(edgeList[i]);
+		out << "From " << g.nodeName(nodeList[i])
+			<< ", take route " << solnEdge.getEdgeID()
+			<< " for " << solnEdge.getEdgeCost() << "km to "
+			<< g.nodeName(nodeList[i + 1]) << endl;
+	}
+
+	out << "\nTotal distance is " << totalCost << "km\n\n";
+}
@@ -0,0 +1,65 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * Path.h
+ */
+
+#ifndef PATH_H
+#define PATH_H
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+#include "GraphTypes.h"
+
+using std::vector;
+
+class Graph;
+
+
+// ---------------------------------------------------------------------------------/
+// The Path class is the result of a search: the route's total cost, and the		/
+// route as contiguous arrays of node indices, from the initial node to the goal,	/
+// and of the indices of the edges between them, so edge(i) leads from node(i)		/
+// to node(i + 1). A search fills it in with one pass back along the parents		/
+// from the goal, and nothing is printed until print() is called, so routes can		/
+// be kept, compared or written out in bulk.										/
+//																					/
+// A Path that was not found has no nodes, and a cost of infinity. A Path can be	/
+// filled in by one query after another, re-using its arrays.						/
+// ---------------------------------------------------------------------------------/
+
+class Path
+{
+public:
+
+	// Constructor, for a route not found
+	//
+
+	Path();
+
+	// public utility functions
+	//
+
+	bool found() const { return !nodeList.empty(); }
+	float cost() const { return totalCost; }
+	std::size_t nodeCount() const { return nodeList.size(); }
+	std::size_t edgeCount() const { return edgeList.size(); }
+	nodeIndex node(const std::size_t i) const { return nodeList[i]; }
+	edgeIndex edge(const std::size_t i) const { return edgeList[i]; }
+	const vector<nodeIndex>& nodes() const { return nodeList; }
+	const vector<edgeIndex>& edges() const { return edgeList; }
+
+	void clear();
+	void reset(const float, const std::size_t);
+	void setStep(const std::size_t, const nodeIndex, const edgeIndex);
+	void setLastNode(const nodeIndex);
+	void print(const Graph&, std::ostream&) const;
+
+private:
+	float totalCost;
+	vector<nodeIndex> nodeList;
+	vector<edgeIndex> edgeList;
+};
+
+#endif /* PATH_H */
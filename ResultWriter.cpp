@@ -0,0 +1,183 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * ResultWriter.cpp
+ */
+
+#include <charconv>
+#include "ResultWriter.h"
+
+using namespace std;
+
+// the buffer is written out once it holds this much
+static const size_t FLUSH_SIZE = 1 << 16;
+
+ResultWriter::ResultWriter(ostream& o, const Format f, const Graph& g) : out(o), format(f), graph(g)
+{
+	buffer.reserve(FLUSH_SIZE + 4096);
+	writeHeader();
+}
+
+ResultWriter::~ResultWriter()
+{
+	flush();
+}
+
+void ResultWriter::write(const nodeIndex initial, const nodeIndex goal, const Path& path, const SearchStats& stats)
+{
+	const vector<nodeIndex>& route = path.nodes();
+	const uint64_t hops = path.edgeCount();
+
+	if (format == CSV)
+	{
+		append(uint64_t(graph.originalId(initial)));
+		append(",");
+		append(uint64_t(graph.originalId(goal)));
+		append(",");
+		if (path.found())
+		{
+			append(path.cost());
+		}
+		else
+		{
+			append("inf");
+		}
+		append(",");
+		append(hops);
+		append(",");
+		for (size_t i = 0; i < route.size(); ++i)
+		{
+			if (i != 0)
+			{
+				append(" ");
+			}
+			append(uint64_t(graph.originalId(route[i])));
+		}
+		append(",");
+		append(stats.seconds);
+		append(",");
+		append(stats.nodesSettled);
+		append(",");
+		append(stats.edgesRelaxed);
+		append(",");
+		append(stats.pushes);
+		append(",");
+		append(stats.pops);
+		append(",");
+		append(stats.decreaseKeys);
+		append(",");
+		append(stats.heuristicEvaluations);
+		append(",");
+		append(uint64_t(stats.peakFrontierSize));
+		append("\n");
+	}
+	else
+	{
+		append("{\"initial\":");
+		append(uint64_t(graph.originalId(initial)));
+		append(",\"goal\":");
+		append(uint64_t(graph.originalId(goal)));
+		append(",\"cost\":");
+		if (path.found())
+		{
+			append(path.cost());
+		}
+		else
+		{
+			append("null");
+		}
+		append(",\"hops\":");
+		append(hops);
+		append(",\"route\":[");
+		for (size_t i = 0; i < route.size(); ++i)
+		{
+			if (i != 0)
+			{
+				append(",");
+			}
+			append(uint64_t(graph.originalId(route[i])));
+		}
+		append("],\"stats\":{\"seconds\":");
+		append(stats.seconds);
+		append(",\"settled\":");
+		append(stats.nodesSettled);
+		append(",\"relaxed\":");
+		append(stats.edgesRelaxed);
+		append(",\"pushes\":");
+		append(stats.pushes);
+		append(",\"pops\":");
+		append(stats.pops);
+		append(",\"decreaseKeys\":");
+		append(stats.decreaseKeys);
+		append(",\"heuristicEvaluations\":");
+		append(stats.heuristicEvaluations);
+		append(",\"peakFrontier\":");
+		append(uint64_t(stats.peakFrontierSize));
+		append("}}\n");
+	}
+
+	if (buffer.size() >= FLUSH_SIZE)
+	{
+		flush();
+	}
+}
+
+void ResultWriter::flush()
+{
+	out.write(buffer.data(), streamsize(buffer.size()));
+	out.flush();
+	buffer.clear();
+}
+
+bool ResultWriter::formatFromName(const string& name, Format& format)
+{
+	if (name == "csv")
+	{
+		format = CSV;
+	}
+	else if (name == "json")
+	{
+		format = JSON;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+void ResultWriter::writeHeader()
+{
+	// JSON lines name every value, so only CSV has a header
+	if (format == CSV)
+	{
+		append("initial,goal,cost,hops,route,seconds,settled,relaxed,pushes,pops,decreaseKeys,heuristicEvaluations,peakFrontier\n");
+	}
+}
+
+void ResultWriter::append(const char* text)
+{
+	buffer.append(text);
+}
+
+void ResultWriter::append(const uint64_t value)
+{
+	char digits[24];
+	const to_chars_result result = to_chars(digits, digits + sizeof(digits), value);
+	buffer.append(digits, result.ptr);
+}
+
+void ResultWriter::append(const float value)
+{
+	// the shortest digits that read back as the same value
+	char digits[32];
+	const to_chars_result result = to_chars(digits, digits + sizeof(digits), value);
+	buffer.append(digits, result.ptr);
+}
+
+void ResultWriter::append(const double value)
+{
+	char digits[32];
+	const to_chars_result result = to_chars(digits, digits + sizeof(digits), value);
+	buffer.append(digits, result.ptr);
+}
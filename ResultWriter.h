@@ -0,0 +1,83 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * ResultWriter.h
+ */
+
+#ifndef RESULT_WRITER_H
+#define RESULT_WRITER_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "GraphTypes.h"
+#include "Graph.h"
+#include "SearchStats.h"
+#include "Path.h"
+
+using std::string;
+using std::vector;
+
+
+// ---------------------------------------------------------------------------------/
+// The ResultWriter class writes the results of route queries to a stream, one		/
+// line per query, for other programs to read:										/
+//																					/
+//		CSV		:	comma separated values, after a header line naming the			/
+//					columns. The route is one column, of node indices separated		/
+//					by spaces.														/
+//		JSON	:	one JSON object per line (JSON lines), with the route as an		/
+//					array of node indices, and the statistics as an object.			/
+//																					/
+// Each result holds the initial and goal nodes, the cost (inf in CSV, or null in	/
+// JSON, when there is no route), the number of edges in the route, the route,		/
+// and the search statistics. Nodes are written by the index they had in the		/
+// graph's text file (Graph::originalId()), so the output is the same whether or	/
+// not the graph was reordered when it was converted.								/
+// Lines are built in a buffer of the writer's own, and written to the stream a		/
+// large block at a time; the rest of the buffer is written by flush(), or when		/
+// the writer is destroyed.															/
+// ---------------------------------------------------------------------------------/
+
+class ResultWriter
+{
+public:
+
+	// Enum for the output format
+	//
+	enum Format { CSV, JSON };
+
+	// Constructor and destructor
+	//
+
+	ResultWriter(std::ostream&, const Format, const Graph&);
+	~ResultWriter();
+
+	// public utility functions
+	//
+
+	void write(const nodeIndex, const nodeIndex, const Path&, const SearchStats&);
+	void flush();
+	static bool formatFromName(const string&, Format&);
+
+private:
+	std::ostream& out;
+	Format format;
+	const Graph& graph;
+	string buffer;
+
+	// private utility functions
+	//
+
+	void writeHeader();
+	void append(const char*);
+	void append(const std::uint64_t);
+	void append(const float);
+	void append(const double);
+
+	// the writer holds a reference to its stream, so it cannot be copied
+	ResultWriter(const ResultWriter&);
+	ResultWriter& operator=(const ResultWriter&);
+};
+
+#endif /* RESULT_WRITER_H */
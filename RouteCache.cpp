@@ -0,0 +1,189 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * RouteCache.cpp
+ */
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include "RouteCache.h"
+
+using namespace std;
+
+RouteCache::RouteCache(const size_t routeCount, const unsigned shardCount) : currentGeneration(0)
+{
+	if (routeCount == 0 || shardCount == 0 || routeCount > 0xFFFFFFFFu)
+	{
+		throw out_of_range("Cache size out of range");
+	}
+
+	// every shard holds at least one route, and the shards share the routes evenly
+	const size_t count = min<size_t>(shardCount, routeCount);
+	shardCapacity = (routeCount + count - 1) / count;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		shards.push_back(unique_ptr<Shard>(new Shard));
+		shards.back()->entries.reset(new Entry[shardCapacity]);
+		shards.back()->index.reserve(shardCapacity);
+	}
+}
+
+bool RouteCache::find(const nodeIndex initial, const nodeIndex goal, const uint32_t algorithm, Path& path)
+{
+	// copies a cached route into path, and returns whether there was one.
+	// Only the shard's shared lock is taken, and a hit only sets the route's
+	// reference bit, so lookups do not hold each other up
+
+	const Key key = { initial, goal, algorithm };
+	Shard& shard = shardFor(key);
+	const uint64_t current = generation();
+
+	{
+		shared_lock<shared_mutex> lock(shard.mutex);
+		unordered_map<Key, uint32_t, KeyHash>::const_iterator it = shard.index.find(key);
+		if (it != shard.index.end())
+		{
+			Entry& entry = shard.entries[it->second];
+			if (entry.generation == current)
+			{
+				entry.referenced.store(true, memory_order_relaxed);
+				path = entry.path;
+				shard.hits.fetch_add(1, memory_order_relaxed);
+				return true;
+			}
+		}
+	}
+
+	shard.misses.fetch_add(1, memory_order_relaxed);
+	return false;
+}
+
+void RouteCache::insert(const nodeIndex initial, const nodeIndex goal, const uint32_t algorithm, const Path& path,
+	const uint64_t searchGeneration)
+{
+	// adds a route, found by a search that started in the given generation. The
+	// route is dropped if the cache has been invalidated since, as the graph
+	// it was found on may have changed
+
+	if (searchGeneration != generation())
+	{
+		return;
+	}
+
+	const Key key = { initial, goal, algorithm };
+	Shard& shard = shardFor(key);
+	unique_lock<shared_mutex> lock(shard.mutex);
+
+	uint32_t slot;
+	unordered_map<Key, uint32_t, KeyHash>::const_iterator it = shard.index.find(key);
+	if (it != shard.index.end())
+	{
+		slot = it->second;
+	}
+	else
+	{
+		slot = freeEntry(shard, searchGeneration);
+		shard.index[key] = slot;
+	}
+
+	Entry& entry = shard.entries[slot];
+	entry.key = key;
+	entry.generation = searchGeneration;
+	entry.referenced.store(true, memory_order_relaxed);
+	entry.path = path;
+}
+
+float RouteCache::findRoute(SearchBase& search, const uint32_t algorithm, const nodeIndex initial, const nodeIndex goal, Path& path)
+{
+	// answers a query from the cache if it can, otherwise with the search,
+	// and caches the route found. Returns the route's cost, or infinity if
+	// there is none, as SearchBase::findRoute() does
+
+	if (find(initial, goal, algorithm, path))
+	{
+		return path.cost();
+	}
+
+	const uint64_t searchGeneration = generation();
+	const float cost = search.findRoute(initial, goal, path);
+	insert(initial, goal, algorithm, path, searchGeneration);
+	return cost;
+}
+
+void RouteCache::invalidate()
+{
+	// every route cached so far is now from an older generation
+	currentGeneration.fetch_add(1, memory_order_acq_rel);
+}
+
+uint64_t RouteCache::generation() const
+{
+	return currentGeneration.load(memory_order_acquire);
+}
+
+RouteCache::Counters RouteCache::counters() const
+{
+	Counters total = { 0, 0, 0 };
+	for (vector<unique_ptr<Shard> >::const_iterator it = shards.cbegin(); it != shards.cend(); ++it)
+	{
+		total.hits += (*it)->hits.load(memory_order_relaxed);
+		total.misses += (*it)->misses.load(memory_order_relaxed);
+		total.evictions += (*it)->evictions.load(memory_order_relaxed);
+	}
+	return total;
+}
+
+size_t RouteCache::capacity() const
+{
+	return shardCapacity * shards.size();
+}
+
+size_t RouteCache::KeyHash::operator()(const Key& key) const
+{
+	// mixes all the bits of the key into all the bits of the hash, as the
+	// shard is picked from the high bits and the map's bucket from the low ones
+	uint64_t h = (uint64_t(key.initial) << 32 | key.goal) ^ (uint64_t(key.algorithm) * 0x9E3779B97F4A7C15ull);
+	h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+	h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+	return size_t(h ^ (h >> 31));
+}
+
+RouteCache::Shard& RouteCache::shardFor(const Key& key) const
+{
+	return *shards[(uint64_t(KeyHash()(key)) >> 32) % shards.size()];
+}
+
+uint32_t RouteCache::freeEntry(Shard& shard, const uint64_t searchGeneration)
+{
+	// finds a slot for a new route, with the shard locked. Unused slots go
+	// first, then the clock hand sweeps the slots: a route of an older
+	// generation is replaced at once, a route used since the last sweep has
+	// its reference bit cleared and is passed over, and the first route that
+	// was not used is evicted
+
+	if (shard.used < shardCapacity)
+	{
+		return shard.used++;
+	}
+
+	for (;;)
+	{
+		const uint32_t slot = shard.hand;
+		shard.hand = uint32_t((shard.hand + 1) % shardCapacity);
+		Entry& entry = shard.entries[slot];
+
+		if (entry.generation < searchGeneration)
+		{
+			shard.index.erase(entry.key);
+			return slot;
+		}
+		if (!entry.referenced.exchange(false, memory_order_relaxed))
+		{
+			shard.index.erase(entry.key);
+			shard.evictions.fetch_add(1, memory_order_relaxed);
+			return slot;
+		}
+	}
+}
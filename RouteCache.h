@@ -0,0 +1,132 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * RouteCache.h
+ */
+
+#ifndef ROUTE_CACHE_H
+#define ROUTE_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+#include "GraphTypes.h"
+#include "Path.h"
+#include "SearchBase.h"
+
+using std::vector;
+
+
+// ---------------------------------------------------------------------------------/
+// The RouteCache class keeps the routes of recent queries, so a query that is		/
+// asked again is answered without searching. A route is keyed by its initial		/
+// node, its goal node, and a number the caller gives to each search algorithm,		/
+// since the searches do not all find the same route.								/
+//																					/
+// The cache holds at most a fixed number of routes, spread over shards by the		/
+// hash of their keys. Each shard has its own lock, taken shared by lookups, so		/
+// any number of threads can read a shard at once; only adding a route takes it		/
+// exclusively. Routes are evicted in CLOCK order: a lookup that hits only sets		/
+// the route's reference bit, and adding a route to a full shard sweeps its			/
+// clock hand over the routes, clearing reference bits, until it finds one that		/
+// has not been used since the last sweep.											/
+//																					/
+// invalidate() empties the whole cache in constant time, when the graph or its		/
+// edge costs change, by starting a new generation: routes from an older			/
+// generation are never returned, and are the first to be replaced. A route			/
+// found by a search that started before invalidate() is not added.					/
+// ---------------------------------------------------------------------------------/
+
+class RouteCache
+{
+public:
+
+	// the cache's counts, summed over the shards
+	struct Counters
+	{
+		std::uint64_t hits;
+		std::uint64_t misses;
+		std::uint64_t evictions;
+	};
+
+	static constexpr unsigned DEFAULT_SHARD_COUNT = 16;
+
+	// Constructor, for at most the given number of routes
+	//
+
+	explicit RouteCache(const std::size_t, const unsigned = DEFAULT_SHARD_COUNT);
+
+	// public utility functions
+	//
+
+	bool find(const nodeIndex, const nodeIndex, const std::uint32_t, Path&);
+	void insert(const nodeIndex, const nodeIndex, const std::uint32_t, const Path&, const std::uint64_t);
+	float findRoute(SearchBase&, const std::uint32_t, const nodeIndex, const nodeIndex, Path&);
+	void invalidate();
+	std::uint64_t generation() const;
+	Counters counters() const;
+	std::size_t capacity() const;
+
+private:
+	struct Key
+	{
+		nodeIndex initial;
+		nodeIndex goal;
+		std::uint32_t algorithm;
+
+		bool operator==(const Key& other) const
+		{
+			return initial == other.initial && goal == other.goal && algorithm == other.algorithm;
+		}
+	};
+
+	struct KeyHash
+	{
+		std::size_t operator()(const Key&) const;
+	};
+
+	struct Entry
+	{
+		Key key;
+		std::uint64_t generation;
+		std::atomic<bool> referenced;
+		Path path;
+
+		Entry() : generation(0), referenced(false) {}
+	};
+
+	struct Shard
+	{
+		std::shared_mutex mutex;
+		std::unordered_map<Key, std::uint32_t, KeyHash> index;
+		std::unique_ptr<Entry[]> entries;
+		std::uint32_t used;
+		std::uint32_t hand;
+
+		std::atomic<std::uint64_t> hits;
+		std::atomic<std::uint64_t> misses;
+		std::atomic<std::uint64_t> evictions;
+
+		Shard() : used(0), hand(0), hits(0), misses(0), evictions(0) {}
+	};
+
+	std::size_t shardCapacity;
+	vector<std::unique_ptr<Shard> > shards;
+	std::atomic<std::uint64_t> currentGeneration;
+
+	// private utility functions
+	//
+
+	Shard& shardFor(const Key&) const;
+	std::uint32_t freeEntry(Shard&, const std::uint64_t);
+
+	// the shards hold locks, so the cache cannot be copied
+	RouteCache(const RouteCache&);
+	RouteCache& operator=(const RouteCache&);
+};
+
+#endif /* ROUTE_CACHE_H */
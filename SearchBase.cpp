@@ -4,46 +4,188 @@
  * SearchBase.cpp
  */
 
+#include <chrono>
 #include <iostream>
-#include <stack>
+#include <limits>
+#include <stdexcept>
 #include "SearchBase.h"
+#include "SpatialIndex.h"
 
-SearchBase::SearchBase(Graph& g) : graph(g)
+SearchBase::SearchBase(const Graph& g) : initialNode(INVALID_NODE), goalNode(INVALID_NODE), graph(g), costData(0)
 {
 	// empty constructor
 }
 
-void SearchBase::printSolution() const
+Path SearchBase::search(const int init, const int goal)
 {
-	//build out the solution...
-	// maybe this is a do...while
-	//
+	// check that both nodes exist before touching their search state
+	if (nodeIndex(init) >= graph.nodeCount() || nodeIndex(goal) >= graph.nodeCount())
+	{
+		throw out_of_range("Node index out of range");
+	}
+
+	// set the initial and goal nodes
+	initialNode = nodeIndex(init);
+	goalNode = nodeIndex(goal);
+
+	// output a message of what we're searching for
+	cout << "Searching for route from " << graph.nodeName(initialNode) << " to " << graph.nodeName(goalNode);
+
+	// this keeps searching until a solution is found
+	Path path;
+	SearchStatus status = run();
+
+	// If FAIL, output a message
+	if( status == SearchStatus::FAILURE )
+	{
+		cout << "\n\nNo solution found.\n\n";
+	}
+	// If SUCCESS, output the solution
+	else if( status == SearchStatus::SUCCESS )
+	{
+		cout << "\n\nSearch Efficiency\n-----------------\nExpanded " << stats.nodesSettled << " nodes\n";
+
+		// print out the solution if found
+		tracePath(path);
+		path.print(graph, cout);
+	}
+
+	// once the search has completed we clear the search state 
+	// (each node cost, state, parent, action) so we can search again
+	finish();
+	return path;
+}
+
+Path SearchBase::search(const Node& from, const Node& to, const SpatialIndex& index)
+{
+	// the route between the nodes nearest two positions. An empty graph has
+	// no nearest node, which is out of range like any other
+	return search(int(index.nearest(from)), int(index.nearest(to)));
+}
+
+float SearchBase::findRoute(const nodeIndex init, const nodeIndex goal)
+{
+	// the same search, without any output. Returns the cost of the route
+	// found, or infinity if there is none
+	return quietRun(init, goal, 0);
+}
+
+float SearchBase::findRoute(const nodeIndex init, const nodeIndex goal, Path& path)
+{
+	// as above, and also fills in path with the route, or clears it if there
+	// is none
+	return quietRun(init, goal, &path);
+}
+
+float SearchBase::findRoute(const Node& from, const Node& to, const SpatialIndex& index, Path& path)
+{
+	// as above, between the nodes nearest two positions
+	return quietRun(index.nearest(from), index.nearest(to), &path);
+}
+
+float SearchBase::quietRun(const nodeIndex init, const nodeIndex goal, Path* path)
+{
+	if (init >= graph.nodeCount() || goal >= graph.nodeCount())
+	{
+		throw out_of_range("Node index out of range");
+	}
+
+	initialNode = init;
+	goalNode = goal;
+	SearchStatus status = run();
+
+	// the route is read off the parents before finish() clears them
+	if (path)
+	{
+		if (status == SearchStatus::SUCCESS)
+		{
+			tracePath(*path);
+		}
+		else
+		{
+			path->clear();
+		}
+	}
+
+	const float cost = (status == SearchStatus::SUCCESS) ? context.stateAt(goalNode).getPathCost() : numeric_limits<float>::infinity();
+	finish();
+	return cost;
+}
+
+const SearchStats& SearchBase::statistics() const
+{
+	// the statistics of the last search
+	return stats;
+}
+
+SearchStatus SearchBase::run()
+{
+	// puts the initial node in the frontier, and expands nodes until the search
+	// succeeds or fails. Only counters are touched in the loop, the clock is
+	// read once at each end
+
+	stats = SearchStats();
+	const chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+	costSnapshot = graph.costTable();
+	costData = costSnapshot->data();
 
-	stack<nodePtr> solnNodePtrStack;
-	nodePtr currentNodePtr = goalNodePtr;
-	solnNodePtrStack.push(goalNodePtr);
+	// a search that throws part way through is finished before the error is
+	// passed on, so its state does not leak into the next query
+	SearchStatus status;
+	try
+	{
+		start();
+		status = processNext();
+		while( status == SearchStatus::SEARCHING )
+		{
+			++stats.nodesSettled;
+			status = processNext();
+		}
+	}
+	catch (...)
+	{
+		finish();
+		throw;
+	}
+
+	collectStats();
+	stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+	return status;
+}
+
+void SearchBase::tracePath(Path& path) const
+{
+	// counts the edges of the route back from the goal, then fills in the
+	// path from its end, so it comes out in order without being reversed
 
-	while (! (currentNodePtr->getParentNode().expired()) )
+	size_t edges = 0;
+	for (nodeIndex n = goalNode; context.stateAt(n).getParentNode() != INVALID_NODE; n = context.stateAt(n).getParentNode())
 	{
-		nodePtr nextNode = currentNodePtr->getParentNode().lock();
-		solnNodePtrStack.push(nextNode);
-		currentNodePtr = nextNode;
-	};
+		++edges;
+	}
 
-	cout << "\nResult\n------\n";
+	path.reset(context.stateAt(goalNode).getPathCost(), edges);
+	path.setLastNode(goalNode);
 
-	while (solnNodePtrStack.top().get() != goalNodePtr.get())
+	nodeIndex currentNode = goalNode;
+	for (size_t i = edges; i-- > 0; )
 	{
-		currentNodePtr = solnNodePtrStack.top();
-		cout << "From " << currentNodePtr->getNodeID();
-		solnNodePtrStack.pop();
-		
-		currentNodePtr = solnNodePtrStack.top();
-		edgePtr solnEdge = currentNodePtr->getParentAction().lock();
-		cout << ", take route " << solnEdge->getEdgeID()
-			<< " for " << solnEdge->getEdgeCost() << "km to "
-			<< currentNodePtr->getNodeID() << endl;	
-	} 
-	
-	cout << "\nTotal distance is " << goalNodePtr->getPathCost() << "km\n\n";
+		const NodeState& current = context.stateAt(currentNode);
+		path.setStep(i, current.getParentNode(), current.getParentAction());
+		currentNode = current.getParentNode();
+	}
+}
+
+void SearchBase::collectStats()
+{
+	// a subclass adds the counts of its frontiers to the statistics
+}
+
+void SearchBase::finish()
+{
+	// starts a new epoch, so every node reads as unexplored again, and lets
+	// go of the costs, in case they have been replaced since
+	context.clear();
+	costSnapshot.reset();
+	costData = 0;
 }
@@ -9,14 +9,41 @@
 
 #include "Node.h"
 #include "Graph.h"
+#include "SearchContext.h"
+#include "SearchStats.h"
+#include "Path.h"
 
 using namespace std;
 
+class SpatialIndex;
+
 // Enum for search status
 //
 
 enum SearchStatus { FAILURE, SEARCHING, SUCCESS };
-	
+
+
+
+// ---------------------------------------------------------------------------------/
+// The SearchBase class is the base of the graph searches. A search only reads		/
+// the Graph, and keeps the state of its query in its own SearchContext, so			/
+// several searches can run on one Graph at the same time, one per thread.			/
+//																					/
+// The base runs the search loop: a subclass sets up its frontier in start(),		/
+// expands one node per call to processNext(), and clears its state in finish().	/
+// search() prints the route found and returns it as a Path, while findRoute()		/
+// runs the same search quietly and returns the cost, filling in a Path if given	/
+// one. Either way the search fills in its SearchStats, read back with				/
+// statistics(); nothing is printed while the search runs. The search state is		/
+// re-used from one query to the next, so a search object can answer many			/
+// queries in a row. Given a SpatialIndex, either will also search between any		/
+// two positions, from the node nearest the first to the node nearest the second.	/
+//																					/
+// Each search takes the Graph's edge costs when it starts, and subclasses read		/
+// them with edgeCost(), so a query runs on one set of costs even if				/
+// Graph::updateEdgeCosts() replaces them part way through.							/
+// ---------------------------------------------------------------------------------/
+
 class SearchBase
 {
 public:
@@ -24,18 +51,43 @@ public:
 	// Constructor
 	//
 
-	SearchBase(Graph&);
+	SearchBase(const Graph&);
+	virtual ~SearchBase() {}
 	
 	// public utility functions
 	//
 
-	virtual void search(const int, const int) = 0;
-	void printSolution() const;
+	Path search(const int, const int);
+	Path search(const Node&, const Node&, const SpatialIndex&);
+	float findRoute(const nodeIndex, const nodeIndex);
+	float findRoute(const nodeIndex, const nodeIndex, Path&);
+	float findRoute(const Node&, const Node&, const SpatialIndex&, Path&);
+	const SearchStats& statistics() const;
+	virtual SearchStatus processNext() = 0;
 
 protected:
-	nodePtr initialNodePtr;
-	nodePtr goalNodePtr;
-	Graph& graph;
+	nodeIndex initialNode;
+	nodeIndex goalNode;
+	const Graph& graph;
+	SearchContext context;
+	SearchStats stats;
+
+	// the graph's edge costs as they were when the search started
+	Graph::CostTable costSnapshot;
+	const float* costData;
+
+	// protected utility functions, for the subclasses
+	//
+
+	float edgeCost(const edgeIndex e) const { return costData[e]; }
+	virtual void start() = 0;
+	virtual void collectStats();
+	virtual void finish();
+
+private:
+	SearchStatus run();
+	float quietRun(const nodeIndex, const nodeIndex, Path*);
+	void tracePath(Path&) const;
 };
 
-#endif /* SEARCH_BASE_H */
\ No newline at end of file
+#endif /* SEARCH_BASE_H */
\ No newline at end of file
@@ -0,0 +1,46 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * SearchContext.cpp
+ */
+
+#include "SearchContext.h"
+
+using namespace std;
+
+const NodeState SearchContext::unexplored;
+
+SearchContext::SearchContext() : epoch(1)
+{
+	// empty constructor
+}
+
+void SearchContext::prepare(const nodeIndex nodeCount)
+{
+	// sizes the context for a graph with the given number of nodes,
+	// keeping the states if it is already the right size.
+	// New entries are stamped with epoch 0, which is never current
+
+	if (entries.size() != nodeCount)
+	{
+		Entry stale = { 0, NodeState() };
+		entries.assign(nodeCount, stale);
+	}
+}
+
+void SearchContext::clear()
+{
+	// starts a new epoch, which makes every state stale, so the context can
+	// be re-used for a new search. Only when the epoch counter wraps around
+	// are the stamps actually reset
+
+	++epoch;
+	if (epoch == 0)
+	{
+		for(vector<Entry>::iterator it=entries.begin(); it!=entries.end(); ++it)
+		{
+			it->epoch = 0;
+		}
+		epoch = 1;
+	}
+}
@@ -0,0 +1,79 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * SearchContext.h
+ */
+
+#ifndef SEARCH_CONTEXT_H
+#define SEARCH_CONTEXT_H
+
+#include <cstdint>
+#include <vector>
+#include "GraphTypes.h"
+#include "NodeState.h"
+
+using std::vector;
+
+
+// ---------------------------------------------------------------------------------/
+// The SearchContext class holds the search state of every node for one query.		/
+// Each search object owns its own context, and only reads the Graph, so any		/
+// number of searches, on any number of threads, can share one loaded Graph.		/
+// The states are allocated by the first query rather than with the search			/
+// object, and re-used by the queries after it.										/
+//																					/
+// Every state is stamped with the epoch of the query that last wrote it, and a		/
+// state with an older stamp reads as a fresh, unexplored one. Clearing the			/
+// context only starts a new epoch, so the cost of a query depends on the nodes		/
+// it touches rather than on the size of the graph.									/
+// ---------------------------------------------------------------------------------/
+
+class SearchContext
+{
+public:
+
+	// Constructor
+	//
+
+	SearchContext();
+
+	// public utility functions
+	//
+
+	void prepare(const nodeIndex);
+	void clear();
+
+	// States are read and written on every edge relaxation,
+	// so the accessors are inlined
+
+	NodeState& stateAt(const nodeIndex n)
+	{
+		Entry& entry = entries[n];
+		if (entry.epoch != epoch)
+		{
+			entry.epoch = epoch;
+			entry.state.clearSearchState();
+		}
+		return entry.state;
+	}
+
+	const NodeState& stateAt(const nodeIndex n) const
+	{
+		const Entry& entry = entries[n];
+		return (entry.epoch == epoch) ? entry.state : unexplored;
+	}
+
+private:
+	// a node's state, and the epoch it was last written in
+	struct Entry
+	{
+		std::uint32_t epoch;
+		NodeState state;
+	};
+
+	vector<Entry> entries;
+	std::uint32_t epoch;
+	static const NodeState unexplored;
+};
+
+#endif /* SEARCH_CONTEXT_H */
@@ -0,0 +1,32 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * SearchStats.cpp
+ */
+
+#include "SearchStats.h"
+
+using namespace std;
+
+SearchStats::SearchStats() : seconds(0.0), nodesSettled(0), pushes(0), pops(0), decreaseKeys(0),
+	edgesRelaxed(0), heuristicEvaluations(0), peakFrontierSize(0)
+{
+	// empty constructor
+}
+
+void SearchStats::addFrontier(const Frontier& frontier)
+{
+	pushes += frontier.pushCount();
+	pops += frontier.popCount();
+	decreaseKeys += frontier.decreaseKeyCount();
+	peakFrontierSize += frontier.peakSize();
+}
+
+void SearchStats::print(ostream& out) const
+{
+	out << "Time " << seconds * 1000.0 << "ms\n"
+		<< "Settled " << nodesSettled << " nodes, relaxed " << edgesRelaxed << " edges\n"
+		<< "Frontier " << pushes << " pushes, " << pops << " pops, " << decreaseKeys
+		<< " decrease keys, peak size " << peakFrontierSize << "\n"
+		<< "Heuristic evaluations " << heuristicEvaluations << "\n";
+}
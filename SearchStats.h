@@ -0,0 +1,53 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * SearchStats.h
+ */
+
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include "Frontier.h"
+
+
+// ---------------------------------------------------------------------------------/
+// The SearchStats struct holds the statistics of one search, filled in as the		/
+// search runs, for monitoring and benchmarks rather than for reading off the		/
+// console. The counts are plain increments, so collecting them costs next to		/
+// nothing, and nothing is printed until print() is called, after the search.		/
+//																					/
+// A node is settled when it is taken from the frontier and expanded, and an		/
+// edge relaxed when it is scanned from a settled node. A heuristic evaluation		/
+// is one estimate of a node's distance to the goal (or a potential, for			/
+// bidirectional A*). The frontier counts are those of all the search's				/
+// frontiers added together, and so is the peak frontier size, which makes it an	/
+// upper bound for the two sided searches.											/
+// ---------------------------------------------------------------------------------/
+
+struct SearchStats
+{
+	double seconds;
+	std::uint64_t nodesSettled;
+	std::uint64_t pushes;
+	std::uint64_t pops;
+	std::uint64_t decreaseKeys;
+	std::uint64_t edgesRelaxed;
+	std::uint64_t heuristicEvaluations;
+	std::size_t peakFrontierSize;
+
+	// Constructor, with every statistic zero
+	//
+
+	SearchStats();
+
+	// public utility functions
+	//
+
+	void addFrontier(const Frontier&);
+	void print(std::ostream&) const;
+};
+
+#endif /* SEARCH_STATS_H */
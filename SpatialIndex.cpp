@@ -0,0 +1,176 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * SpatialIndex.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "SpatialIndex.h"
+
+using namespace std;
+
+// the earth's radius in km, and degrees to radians, as Node::linearDistanceTo() has them
+static const double EARTH_RADIUS = 6371.0;
+static const double TO_RAD = 0.01745329251994329;
+
+SpatialIndex::SpatialIndex(const Graph& g) : graph(g)
+{
+	entries.reserve(g.nodeCount());
+	for (nodeIndex n = 0; n < g.nodeCount(); ++n)
+	{
+		entries.push_back(toEntry(g.nodeLatitude(n), g.nodeLongitude(n), n));
+	}
+	splitAxis.assign(entries.size(), 0);
+	build(0, entries.size());
+}
+
+nodeIndex SpatialIndex::nodeCount() const
+{
+	return nodeIndex(entries.size());
+}
+
+nodeIndex SpatialIndex::nearest(const Node& position) const
+{
+	// the node nearest the position, or INVALID_NODE if the graph has none
+	vector<nodeIndex> found;
+	query(position, 1, numeric_limits<double>::infinity(), found);
+	return found.empty() ? INVALID_NODE : found.front();
+}
+
+void SpatialIndex::nearest(const Node& position, const size_t k, vector<nodeIndex>& found) const
+{
+	// the k nodes nearest the position, or all of them if there are fewer
+	query(position, k, numeric_limits<double>::infinity(), found);
+}
+
+void SpatialIndex::withinRadius(const Node& position, const float radius, vector<nodeIndex>& found) const
+{
+	// every node no more than radius km from the position. The tree is searched
+	// a little beyond the radius, to allow for rounding, and the nodes found
+	// are then measured as the searches measure distances
+
+	found.clear();
+	if (!(radius >= 0.0f))
+	{
+		return;
+	}
+
+	const double angle = min(double(radius) / EARTH_RADIUS, 3.14159265358979323846);
+	const double chord = 2.0 * sin(angle / 2.0) * (1.0 + 1e-6) + 1e-9;
+	query(position, numeric_limits<size_t>::max(), chord * chord, found);
+
+	found.erase(remove_if(found.begin(), found.end(), [this, &position, radius](const nodeIndex n)
+		{ return graph.nodeAt(n).linearDistanceTo(position) > radius; }), found.end());
+}
+
+SpatialIndex::Entry SpatialIndex::toEntry(const float latitude, const float longitude, const nodeIndex node)
+{
+	const double lat = TO_RAD * latitude;
+	const double lon = TO_RAD * longitude;
+	const Entry entry = { { cos(lat) * cos(lon), cos(lat) * sin(lon), sin(lat) }, node };
+	return entry;
+}
+
+void SpatialIndex::build(const size_t first, const size_t last)
+{
+	// splits the range at its middle, on the axis it is widest along, and
+	// builds each side the same way
+
+	if (last - first < 2)
+	{
+		return;
+	}
+
+	double low[3] = { 1.0, 1.0, 1.0 };
+	double high[3] = { -1.0, -1.0, -1.0 };
+	for (size_t i = first; i < last; ++i)
+	{
+		for (int a = 0; a < 3; ++a)
+		{
+			low[a] = min(low[a], entries[i].point[a]);
+			high[a] = max(high[a], entries[i].point[a]);
+		}
+	}
+	int axis = 0;
+	for (int a = 1; a < 3; ++a)
+	{
+		if (high[a] - low[a] > high[axis] - low[axis])
+		{
+			axis = a;
+		}
+	}
+
+	const size_t middle = first + (last - first) / 2;
+	nth_element(entries.begin() + first, entries.begin() + middle, entries.begin() + last,
+		[axis](const Entry& a, const Entry& b) { return a.point[axis] < b.point[axis]; });
+	splitAxis[middle] = uint8_t(axis);
+
+	build(first, middle);
+	build(middle + 1, last);
+}
+
+void SpatialIndex::collect(const size_t first, const size_t last, const Entry& target, const size_t k, const double limit,
+	vector<Candidate>& best) const
+{
+	// adds the nodes of the range that are nearer than the limit, and among the
+	// k nearest found so far, to best, which is a heap with the farthest on top
+
+	if (first >= last)
+	{
+		return;
+	}
+
+	const size_t middle = first + (last - first) / 2;
+	const Entry& entry = entries[middle];
+	const double dx = entry.point[0] - target.point[0];
+	const double dy = entry.point[1] - target.point[1];
+	const double dz = entry.point[2] - target.point[2];
+	const Candidate candidate(dx * dx + dy * dy + dz * dz, entry.node);
+
+	if (candidate.first <= limit && (best.size() < k || candidate < best.front()))
+	{
+		if (best.size() == k)
+		{
+			pop_heap(best.begin(), best.end());
+			best.pop_back();
+		}
+		best.push_back(candidate);
+		push_heap(best.begin(), best.end());
+	}
+
+	// the side the target is on first, then the other if it could be near enough
+	const int axis = splitAxis[middle];
+	const double offset = target.point[axis] - entry.point[axis];
+	const bool before = (offset < 0.0);
+	collect(before ? first : middle + 1, before ? middle : last, target, k, limit, best);
+
+	const double reach = (best.size() == k) ? min(limit, best.front().first) : limit;
+	if (offset * offset <= reach)
+	{
+		collect(before ? middle + 1 : first, before ? last : middle, target, k, limit, best);
+	}
+}
+
+void SpatialIndex::query(const Node& position, const size_t k, const double limit, vector<nodeIndex>& found) const
+{
+	// the k nearest nodes within the squared chord distance limit, nearest
+	// first, and by index between nodes at the same distance
+
+	found.clear();
+	if (k == 0)
+	{
+		return;
+	}
+
+	vector<Candidate> best;
+	collect(0, entries.size(), toEntry(position.getLatitude(), position.getLongitude(), INVALID_NODE), k, limit, best);
+
+	sort_heap(best.begin(), best.end());
+	found.reserve(best.size());
+	for (vector<Candidate>::const_iterator it = best.cbegin(); it != best.cend(); ++it)
+	{
+		found.push_back(it->second);
+	}
+}
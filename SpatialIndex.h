@@ -0,0 +1,81 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * SpatialIndex.h
+ */
+
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "GraphTypes.h"
+#include "Graph.h"
+#include "Node.h"
+
+using std::vector;
+
+
+// ---------------------------------------------------------------------------------/
+// The SpatialIndex class finds the nodes of a Graph nearest to any latitude and	/
+// longitude, such as a GPS position, so a route can be searched for between		/
+// places that are not nodes themselves.											/
+//																					/
+// Each node is placed on the unit sphere, as an x, y, z point, where the straight	/
+// line (chord) between two points grows with the great circle distance between		/
+// them, so the nearest points are the nearest nodes, with no special cases at		/
+// the poles or the date line. The points are kept in a static k-d tree, packed		/
+// in one array: the node in the middle of a range splits it, on the axis along		/
+// which the range is widest, into the nodes before it and the nodes after it.		/
+// A query goes down the side of each split that it is on first, and only looks		/
+// at the other side if it could hold something nearer than what has been found.	/
+//																					/
+// The index is built once from the graph's coordinates, which do not change.		/
+// Results come nearest first, with distances as Node::linearDistanceTo()			/
+// measures them.																	/
+// ---------------------------------------------------------------------------------/
+
+class SpatialIndex
+{
+public:
+
+	// Constructor, which builds the tree
+	//
+
+	explicit SpatialIndex(const Graph&);
+
+	// public utility functions
+	//
+
+	nodeIndex nodeCount() const;
+	nodeIndex nearest(const Node&) const;
+	void nearest(const Node&, const std::size_t, vector<nodeIndex>&) const;
+	void withinRadius(const Node&, const float, vector<nodeIndex>&) const;
+
+private:
+	// a node's point on the unit sphere
+	struct Entry
+	{
+		double point[3];
+		nodeIndex node;
+	};
+
+	// a node found by a query, and its squared chord distance
+	typedef std::pair<double, nodeIndex> Candidate;
+
+	const Graph& graph;
+	vector<Entry> entries;
+	vector<std::uint8_t> splitAxis;
+
+	// private utility functions
+	//
+
+	static Entry toEntry(const float, const float, const nodeIndex);
+	void build(const std::size_t, const std::size_t);
+	void collect(const std::size_t, const std::size_t, const Entry&, const std::size_t, const double, vector<Candidate>&) const;
+	void query(const Node&, const std::size_t, const double, vector<nodeIndex>&) const;
+};
+
+#endif /* SPATIAL_INDEX_H */
@@ -0,0 +1,175 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * StringTable.cpp
+ */
+
+#include <stdexcept>
+#include "StringTable.h"
+
+using namespace std;
+
+StringTable::StringTable()
+{
+	clear();
+}
+
+uint32_t StringTable::find(string_view s) const
+{
+	return find(s, hash(s));
+}
+
+uint32_t StringTable::find(string_view s, const uint32_t h) const
+{
+	// probe the index starting at the string's hash slot, until either
+	// the string or an empty slot is found. The hash is passed in when the
+	// caller already has it, for example from a loader thread
+
+	const uint32_t mask = uint32_t(slots.size() - 1);
+	for (uint32_t slot = h & mask; ; slot = (slot + 1) & mask)
+	{
+		const uint32_t id = slots[slot];
+		if (id == NOT_FOUND || at(id) == s)
+		{
+			return id;
+		}
+	}
+}
+
+uint32_t StringTable::intern(string_view s)
+{
+	return intern(s, hash(s));
+}
+
+uint32_t StringTable::intern(string_view s, const uint32_t h)
+{
+	// returns the id of the string, adding it to the table first if it is
+	// not already there. A caller can tell a new string was added because
+	// its id is equal to the size of the table before the call.
+
+	uint32_t id = find(s, h);
+	if (id != NOT_FOUND)
+	{
+		return id;
+	}
+
+	if (chars.size() + s.size() > 0xFFFFFFFFu)
+	{
+		throw length_error("String table is full");
+	}
+
+	id = size();
+	chars.append(s.begin(), s.end());
+	offsets.push_back(uint32_t(chars.size()));
+
+	// keep the index at most half full, so probe sequences stay short
+	if (2 * size() > slots.size())
+	{
+		growIndex();
+	}
+	else
+	{
+		insertIntoIndex(id, h);
+	}
+	return id;
+}
+
+void StringTable::reserve(const uint32_t count, const size_t totalLength)
+{
+	// pre-size the buffers when the number of strings is known up front,
+	// so loading a large file does not repeatedly reallocate and rehash
+
+	chars.reserve(totalLength);
+	offsets.reserve(size_t(count) + 1);
+
+	size_t wanted = slots.size();
+	while (wanted < 2 * size_t(count))
+	{
+		wanted *= 2;
+	}
+	if (wanted != slots.size())
+	{
+		slots.assign(wanted, NOT_FOUND);
+		for (uint32_t id = 0; id < size(); ++id)
+		{
+			insertIntoIndex(id, hash(at(id)));
+		}
+	}
+}
+
+void StringTable::clear()
+{
+	// clearing the arrays first releases their memory, which assign() keeps
+	chars.clear();
+	offsets.clear();
+	offsets.push_back(0);
+	slots.clear();
+	slots.assign(16, NOT_FOUND);
+}
+
+void StringTable::attach(const MappedArray<char>& c, const MappedArray<uint32_t>& o, const MappedArray<uint32_t>& s)
+{
+	// views a table that was built elsewhere, usually sections of a mapped
+	// graph file. The slot count must be a power of two, with at least one
+	// empty slot, for find() to terminate. The offsets must run in order from
+	// the start to the end of the characters, and every slot be empty or hold
+	// the id of a string, so no lookup reads outside the arrays
+
+	if (o.empty() || s.empty() || (s.size() & (s.size() - 1)) != 0 || s.size() <= o.size() - 1 ||
+		o[0] != 0 || o[o.size() - 1] != c.size())
+	{
+		throw runtime_error("String table is corrupt");
+	}
+	for (size_t i = 1; i < o.size(); ++i)
+	{
+		if (o[i] < o[i - 1])
+		{
+			throw runtime_error("String table is corrupt");
+		}
+	}
+	for (size_t i = 0; i < s.size(); ++i)
+	{
+		if (s[i] != NOT_FOUND && s[i] >= o.size() - 1)
+		{
+			throw runtime_error("String table is corrupt");
+		}
+	}
+
+	chars = c;
+	offsets = o;
+	slots = s;
+}
+
+uint32_t StringTable::hash(string_view s)
+{
+	// 32 bit FNV-1a
+	uint32_t h = 2166136261u;
+	for (string_view::const_iterator it = s.begin(); it != s.end(); ++it)
+	{
+		h ^= uint8_t(*it);
+		h *= 16777619u;
+	}
+	return h;
+}
+
+void StringTable::growIndex()
+{
+	// double the number of slots and re-insert every id
+
+	slots.assign(slots.size() * 2, NOT_FOUND);
+	for (uint32_t id = 0; id < size(); ++id)
+	{
+		insertIntoIndex(id, hash(at(id)));
+	}
+}
+
+void StringTable::insertIntoIndex(const uint32_t id, const uint32_t h)
+{
+	const uint32_t mask = uint32_t(slots.size() - 1);
+	uint32_t slot = h & mask;
+	while (slots[slot] != NOT_FOUND)
+	{
+		slot = (slot + 1) & mask;
+	}
+	slots.modify(slot) = id;
+}
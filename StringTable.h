@@ -0,0 +1,82 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * StringTable.h
+ */
+
+#ifndef STRING_TABLE_H
+#define STRING_TABLE_H
+
+#include <cstdint>
+#include <string_view>
+#include "MappedArray.h"
+
+using std::string_view;
+
+
+// ---------------------------------------------------------------------------------/
+// The StringTable class interns strings: every distinct string is stored once,		/
+// back to back in a single character buffer, and is identified by a 32 bit id		/
+// given in insertion order.														/
+//																					/
+// A hash index (open addressing with linear probing over the ids) maps a string	/
+// back to its id in expected constant time. The hash function is fixed (FNV-1a)	/
+// rather than std::hash, so the index does not depend on the standard library.		/
+//																					/
+// All three arrays are MappedArrays, so a table written to a binary graph file		/
+// can be attached straight from the mapped file and used without rebuilding.		/
+// ---------------------------------------------------------------------------------/
+
+class StringTable
+{
+public:
+
+	static constexpr std::uint32_t NOT_FOUND = 0xFFFFFFFFu;
+
+	// Constructor
+	//
+
+	StringTable();
+
+	// public utility functions
+	//
+
+	std::uint32_t find(string_view) const;
+	std::uint32_t find(string_view, const std::uint32_t) const;
+	std::uint32_t intern(string_view);
+	std::uint32_t intern(string_view, const std::uint32_t);
+	void reserve(const std::uint32_t, const std::size_t);
+	void clear();
+	void attach(const MappedArray<char>&, const MappedArray<std::uint32_t>&, const MappedArray<std::uint32_t>&);
+
+	// Strings are read on every lookup and every printout,
+	// so the accessors are inlined
+
+	std::uint32_t size() const { return std::uint32_t(offsets.size() - 1); }
+	string_view at(const std::uint32_t id) const
+	{
+		return string_view(chars.data() + offsets[id], offsets[id + 1] - offsets[id]);
+	}
+
+	static std::uint32_t hash(string_view);
+
+	// The raw arrays, for writing the table to a binary file
+	//
+
+	const MappedArray<char>& characterArray() const { return chars; }
+	const MappedArray<std::uint32_t>& offsetArray() const { return offsets; }
+	const MappedArray<std::uint32_t>& slotArray() const { return slots; }
+
+private:
+	MappedArray<char> chars;
+	MappedArray<std::uint32_t> offsets;
+	MappedArray<std::uint32_t> slots;
+
+	// private utility functions
+	//
+
+	void growIndex();
+	void insertIntoIndex(const std::uint32_t, const std::uint32_t);
+};
+
+#endif /* STRING_TABLE_H */
@@ -0,0 +1,119 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * ThreadPool.cpp
+ */
+
+#include "ThreadPool.h"
+
+using namespace std;
+
+ThreadPool::ThreadPool(const unsigned threadCount) : busyCount(0), stopping(false)
+{
+	unsigned count = threadCount;
+	if (count == 0)
+	{
+		count = thread::hardware_concurrency();
+	}
+	if (count == 0)
+	{
+		count = 1;
+	}
+
+	for (unsigned i = 0; i < count; ++i)
+	{
+		workers.push_back(thread(&ThreadPool::workerLoop, this));
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	// let the workers finish the queued tasks, then stop them
+	{
+		unique_lock<mutex> lock(queueMutex);
+		stopping = true;
+	}
+	taskReady.notify_all();
+
+	for (vector<thread>::iterator it = workers.begin(); it != workers.end(); ++it)
+	{
+		it->join();
+	}
+}
+
+void ThreadPool::submit(const function<void()>& task)
+{
+	{
+		unique_lock<mutex> lock(queueMutex);
+		tasks.push_back(task);
+	}
+	taskReady.notify_one();
+}
+
+void ThreadPool::wait()
+{
+	// blocks until the queue is empty and no worker is running a task,
+	// then reports the first error a task threw since the last wait()
+
+	unique_lock<mutex> lock(queueMutex);
+	while (!tasks.empty() || busyCount > 0)
+	{
+		allDone.wait(lock);
+	}
+
+	if (firstError)
+	{
+		exception_ptr error = firstError;
+		firstError = exception_ptr();
+		rethrow_exception(error);
+	}
+}
+
+unsigned ThreadPool::size() const
+{
+	return unsigned(workers.size());
+}
+
+void ThreadPool::workerLoop()
+{
+	for (;;)
+	{
+		function<void()> task;
+		{
+			unique_lock<mutex> lock(queueMutex);
+			while (tasks.empty() && !stopping)
+			{
+				taskReady.wait(lock);
+			}
+			if (tasks.empty())
+			{
+				return;
+			}
+			task = tasks.front();
+			tasks.pop_front();
+			++busyCount;
+		}
+
+		try
+		{
+			task();
+		}
+		catch (...)
+		{
+			unique_lock<mutex> lock(queueMutex);
+			if (!firstError)
+			{
+				firstError = current_exception();
+			}
+		}
+
+		{
+			unique_lock<mutex> lock(queueMutex);
+			--busyCount;
+			if (tasks.empty() && busyCount == 0)
+			{
+				allDone.notify_all();
+			}
+		}
+	}
+}
@@ -0,0 +1,66 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * ThreadPool.h
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::vector;
+
+
+// ---------------------------------------------------------------------------------/
+// The ThreadPool class runs tasks on a fixed set of worker threads.				/
+// Tasks are taken from a shared queue in the order they were submitted. wait()		/
+// blocks until every submitted task has finished, and rethrows the first			/
+// exception thrown by a task, if any.												/
+// ---------------------------------------------------------------------------------/
+
+class ThreadPool
+{
+public:
+
+	// Constructor and destructor
+	// a thread count of 0 starts one worker per hardware thread
+	//
+
+	explicit ThreadPool(const unsigned = 0);
+	~ThreadPool();
+
+	// public utility functions
+	//
+
+	void submit(const std::function<void()>&);
+	void wait();
+	unsigned size() const;
+
+private:
+	vector<std::thread> workers;
+	std::deque<std::function<void()> > tasks;
+	std::mutex queueMutex;
+	std::condition_variable taskReady;
+	std::condition_variable allDone;
+	unsigned busyCount;
+	bool stopping;
+	std::exception_ptr firstError;
+
+	// private utility functions
+	//
+
+	void workerLoop();
+
+	// the pool owns its threads, so it cannot be copied
+	ThreadPool(const ThreadPool&);
+	ThreadPool& operator=(const ThreadPool&);
+};
+
+#endif /* THREAD_POOL_H */
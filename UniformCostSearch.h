@@ -7,29 +7,19 @@
 #ifndef UNIFORM_COST_SEARCH_H
 #define UNIFORM_COST_SEARCH_H
 
-#include <boost/heap/binomial_heap.hpp>
-#include "SearchBase.h"
+#include "GraphSearch.h"
 
 
 using namespace std;
 
-class UniformCostSearch : public SearchBase
+class UniformCostSearch : public GraphSearch<NoEstimate, CostPriority>
 {
 public:
 
 	// Constructor
 	//
 
-	UniformCostSearch(Graph&);
-	
-	// public utility functions
-	//
-
-	virtual void search(const int, const int);
-	SearchStatus processNext();
-
-private:
-	boost::heap::binomial_heap<nodePtr, boost::heap::compare<NodeCompareCost> > frontier;
+	UniformCostSearch(const Graph&, const Frontier::Type = Frontier::D_ARY_HEAP);
 };
 
 #endif /* UNIFORM_COST_SEARCH_H */
\ No newline at end of file
@@ -0,0 +1,174 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * WorkStealingPool.cpp
+ */
+
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+WorkStealingPool::WorkStealingPool(const unsigned threadCount) : task(0), generation(0), pendingChunks(0), stopping(false)
+{
+	unsigned count = threadCount;
+	if (count == 0)
+	{
+		count = thread::hardware_concurrency();
+	}
+	if (count == 0)
+	{
+		count = 1;
+	}
+
+	// every queue exists before any worker starts looking in them
+	for (unsigned i = 0; i < count; ++i)
+	{
+		queues.push_back(unique_ptr<WorkQueue>(new WorkQueue));
+	}
+	for (unsigned i = 0; i < count; ++i)
+	{
+		workers.push_back(thread(&WorkStealingPool::workerLoop, this, i));
+	}
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+	{
+		unique_lock<mutex> lock(poolMutex);
+		stopping = true;
+	}
+	workReady.notify_all();
+
+	for (vector<thread>::iterator it = workers.begin(); it != workers.end(); ++it)
+	{
+		it->join();
+	}
+}
+
+void WorkStealingPool::run(const size_t count, const size_t grain, const Task& runTask)
+{
+	// cuts [0, count) into chunks of grain indices, deals each worker an equal,
+	// contiguous share of the chunks, and waits for all of them to finish
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	const size_t chunkSize = (grain == 0) ? 1 : grain;
+	const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+	const size_t workerCount = queues.size();
+
+	unique_lock<mutex> lock(poolMutex);
+	task = &runTask;
+	pendingChunks = chunkCount;
+	firstError = exception_ptr();
+
+	for (size_t w = 0; w < workerCount; ++w)
+	{
+		unique_lock<mutex> queueLock(queues[w]->mutex);
+		for (size_t c = chunkCount * w / workerCount; c < chunkCount * (w + 1) / workerCount; ++c)
+		{
+			Chunk chunk = { c * chunkSize, min(count, (c + 1) * chunkSize) };
+			queues[w]->chunks.push_back(chunk);
+		}
+	}
+
+	++generation;
+	workReady.notify_all();
+	while (pendingChunks > 0)
+	{
+		allDone.wait(lock);
+	}
+	task = 0;
+
+	if (firstError)
+	{
+		exception_ptr error = firstError;
+		firstError = exception_ptr();
+		rethrow_exception(error);
+	}
+}
+
+unsigned WorkStealingPool::size() const
+{
+	return unsigned(workers.size());
+}
+
+void WorkStealingPool::workerLoop(const unsigned worker)
+{
+	uint64_t seenGeneration = 0;
+	for (;;)
+	{
+		// sleep until a new run starts, or the pool is stopping
+		{
+			unique_lock<mutex> lock(poolMutex);
+			while (generation == seenGeneration && !stopping)
+			{
+				workReady.wait(lock);
+			}
+			if (stopping)
+			{
+				return;
+			}
+			seenGeneration = generation;
+		}
+
+		// the task is set before any chunk of its run is queued, and the chunk
+		// is taken under the same queue lock it was queued under, so it is safe
+		// to read here
+		Chunk chunk;
+		while (takeChunk(worker, chunk))
+		{
+			try
+			{
+				(*task)(worker, chunk.begin, chunk.end);
+			}
+			catch (...)
+			{
+				unique_lock<mutex> lock(poolMutex);
+				if (!firstError)
+				{
+					firstError = current_exception();
+				}
+			}
+
+			unique_lock<mutex> lock(poolMutex);
+			if (--pendingChunks == 0)
+			{
+				allDone.notify_all();
+			}
+		}
+	}
+}
+
+bool WorkStealingPool::takeChunk(const unsigned worker, Chunk& chunk)
+{
+	// the next chunk of the worker's own queue, or else the last chunk of the
+	// first other queue that has any, which is the work its owner would get
+	// to last
+
+	{
+		WorkQueue& own = *queues[worker];
+		unique_lock<mutex> lock(own.mutex);
+		if (!own.chunks.empty())
+		{
+			chunk = own.chunks.front();
+			own.chunks.pop_front();
+			return true;
+		}
+	}
+
+	for (size_t i = 1; i < queues.size(); ++i)
+	{
+		WorkQueue& victim = *queues[(worker + i) % queues.size()];
+		unique_lock<mutex> lock(victim.mutex);
+		if (!victim.chunks.empty())
+		{
+			chunk = victim.chunks.back();
+			victim.chunks.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
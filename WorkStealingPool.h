@@ -0,0 +1,97 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * WorkStealingPool.h
+ */
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::vector;
+
+
+// ---------------------------------------------------------------------------------/
+// The WorkStealingPool class runs a loop over an index range on a fixed set of		/
+// worker threads, for many small tasks of uneven cost, such as route queries.		/
+//																					/
+// run() cuts the range into chunks, and gives each worker a contiguous run of		/
+// them in a queue of its own. A worker takes chunks from the front of its own		/
+// queue, without contending with the others; once it is empty, it steals from		/
+// the back of another worker's queue, so no worker is left idle while another		/
+// has a backlog. The task is told which worker runs it, so it can keep scratch		/
+// space per worker and re-use it from one chunk to the next.						/
+//																					/
+// run() blocks until every chunk has finished, and rethrows the first exception	/
+// thrown by the task, if any. The threads are kept for the next run().				/
+// ---------------------------------------------------------------------------------/
+
+class WorkStealingPool
+{
+public:
+
+	// the task, given the worker running it and a chunk [begin, end) of the range
+	typedef std::function<void(unsigned, std::size_t, std::size_t)> Task;
+
+	// Constructor and destructor
+	// a thread count of 0 starts one worker per hardware thread
+	//
+
+	explicit WorkStealingPool(const unsigned = 0);
+	~WorkStealingPool();
+
+	// public utility functions
+	//
+
+	void run(const std::size_t, const std::size_t, const Task&);
+	unsigned size() const;
+
+private:
+	struct Chunk
+	{
+		std::size_t begin;
+		std::size_t end;
+	};
+
+	// a worker's own chunks, which other workers may steal from
+	struct WorkQueue
+	{
+		std::mutex mutex;
+		std::deque<Chunk> chunks;
+	};
+
+	vector<std::thread> workers;
+	vector<std::unique_ptr<WorkQueue> > queues;
+
+	// the current run, guarded by poolMutex
+	std::mutex poolMutex;
+	std::condition_variable workReady;
+	std::condition_variable allDone;
+	const Task* task;
+	std::uint64_t generation;
+	std::size_t pendingChunks;
+	bool stopping;
+	std::exception_ptr firstError;
+
+	// private utility functions
+	//
+
+	void workerLoop(const unsigned);
+	bool takeChunk(const unsigned, Chunk&);
+
+	// the pool owns its threads, so it cannot be copied
+	WorkStealingPool(const WorkStealingPool&);
+	WorkStealingPool& operator=(const WorkStealingPool&);
+};
+
+#endif /* WORK_STEALING_POOL_H */
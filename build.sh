@@ -3,4 +3,17 @@
 #
 # build.sh
 #
-g++ -ansi -Wall -pedantic -std=c++0x -Iboost_1_51_0 -o search *.cpp
+CXXFLAGS="-Wall -pedantic -std=c++17 -pthread -Iboost_1_51_0 -I."
+SOURCES=`ls *.cpp | grep -v '^main.cpp$'`
+
+# the interactive search program
+g++ $CXXFLAGS -o search main.cpp $SOURCES
+
+# text to binary graph file converter
+g++ $CXXFLAGS -o graphconvert tools/graphconvert.cpp $SOURCES
+
+# synthetic graph generator
+g++ $CXXFLAGS -o graphgen tools/graphgen.cpp $SOURCES
+
+# search benchmark, optimized, as its timings are what it is for
+g++ $CXXFLAGS -O2 -o benchmark tools/benchmark.cpp $SOURCES
@@ -7,16 +7,39 @@
 #include <iostream>
 #include <exception>
 #include <fstream>
+#include <sstream>
 #include <cstdlib>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <boost/shared_ptr.hpp>
 
 #include "Graph.h"
 #include "BestFirstSearch.h"
 #include "UniformCostSearch.h"
 #include "AStarSearch.h"
+#include "Landmarks.h"
+#include "BidirectionalDijkstraSearch.h"
+#include "BidirectionalAStarSearch.h"
+#include "ContractionHierarchySearch.h"
+#include "CustomizableHierarchySearch.h"
+#include "FixedCostSearch.h"
+#include "SpatialIndex.h"
+#include "LineReader.h"
+#include "CsvParser.h"
+#include "ResultWriter.h"
+#include "BatchExecutor.h"
+#include "RouteCache.h"
 
 using namespace std;
 
+// a query of the batch mode, from the initial node to the goal node
+typedef BatchExecutor::Query BatchQuery;
+
+// with more than one thread, the queries are answered this many at a time
+static const size_t BATCH_BLOCK_SIZE = 4096;
+
 string getFilename()
 {
 	// READ A FILE NAME
@@ -26,8 +49,350 @@ string getFilename()
 	return filename;
 }
 
-int main()
+void loadGraph(const string& filename, Graph& g)
+{
+	// binary graph files are mapped, anything else is parsed as text
+	if (Graph::isBinaryFile(filename))
+	{
+		g.readBinaryFile(filename);
+	}
+	else
+	{
+		g.readFile(filename.c_str());
+	}
+}
+
+void loadLandmarks(const string& filename, const Graph& g, Landmarks& landmarks)
+{
+	// landmark tables saved next to the graph are mapped, otherwise computed now.
+	// A saved file that no longer fits the graph, because the graph has changed
+	// since, or that is corrupt, is passed over with a warning
+	if (Landmarks::isLandmarkFile(filename + ".landmarks"))
+	{
+		try
+		{
+			landmarks.readFile(filename + ".landmarks", g);
+			return;
+		}
+		catch (runtime_error& e)
+		{
+			cerr << "Warning : " << filename << ".landmarks not used, " << e.what() << endl;
+		}
+	}
+	landmarks.build(g);
+}
+
+nodeIndex findQueryNode(const Graph& g, string_view field)
+{
+	// a query node is given by name, or failing that by the index it had in
+	// the graph's text file, which is not its index if the graph was reordered
+
+	nodeIndex node = g.findNode(field);
+	if (node == INVALID_NODE)
+	{
+		unsigned long index;
+		const from_chars_result result = from_chars(field.data(), field.data() + field.size(), index);
+		if (result.ec == errc() && result.ptr == field.data() + field.size() && index < g.nodeCount())
+		{
+			node = g.findOriginalNode(nodeIndex(index));
+		}
+	}
+	if (node == INVALID_NODE)
+	{
+		string errorString = "Query file error : Node " + string(field) + " does not exist.";
+		throw runtime_error(errorString.c_str());
+	}
+	return node;
+}
+
+float parseCoordinate(string_view field, const float limit)
+{
+	// a latitude or longitude in degrees, no more than limit either way
+	float value;
+	const from_chars_result result = from_chars(field.data(), field.data() + field.size(), value);
+	if (result.ec != errc() || result.ptr != field.data() + field.size() || !(value >= -limit && value <= limit))
+	{
+		string errorString = "Query file error : Did not recognize '" + string(field) + "' as a coordinate";
+		throw runtime_error(errorString.c_str());
+	}
+	return value;
+}
+
+void readQueries(const string& filename, const Graph& g, vector<BatchQuery>& queries, boost::shared_ptr<SpatialIndex>& index)
 {
+	// the query file has one query per line, the initial and goal nodes
+	// separated by a comma, in the same format as the graph file. A line of
+	// four fields is the latitude and longitude of the start and of the goal
+	// instead, which are snapped to their nearest nodes with a spatial index,
+	// built for the first such line. Blank lines are skipped
+
+	ifstream queryFile(filename, ios::in | ios::binary);
+	if (!queryFile)
+	{
+		throw runtime_error("Could not open the file.");
+	}
+	ostringstream contents;
+	contents << queryFile.rdbuf();
+	const string text = contents.str();
+
+	LineReader lines(text.data(), text.data() + text.size());
+	CsvParser parser;
+	string_view line;
+	string_view fields[4];
+	while (lines.nextLine(line))
+	{
+		if (line.empty())
+		{
+			continue;
+		}
+
+		const int fieldCount = parser.split(line, fields, 4);
+		if (fieldCount == 2)
+		{
+			BatchQuery query = { findQueryNode(g, fields[0]), findQueryNode(g, fields[1]) };
+			queries.push_back(query);
+		}
+		else if (fieldCount == 4 && g.nodeCount() > 0)
+		{
+			const Node from(parseCoordinate(fields[0], 90.0f), parseCoordinate(fields[1], 180.0f));
+			const Node to(parseCoordinate(fields[2], 90.0f), parseCoordinate(fields[3], 180.0f));
+			if (!index)
+			{
+				index.reset(new SpatialIndex(g));
+			}
+			BatchQuery query = { index->nearest(from), index->nearest(to) };
+			queries.push_back(query);
+		}
+		else
+		{
+			string errorString = "Query file error : Did not recognize '" + string(line) + "' as a query";
+			throw runtime_error(errorString.c_str());
+		}
+	}
+}
+
+SearchBase* makeSearch(const string& algorithm, const string& filename, const Graph& g,
+	Landmarks& landmarks, boost::shared_ptr<ContractionHierarchy>& hierarchy,
+	boost::shared_ptr<CustomizableHierarchy>& customizable, boost::shared_ptr<FixedCosts>& fixedCosts)
+{
+	// the search named on the command line. Its preprocessing is done for the
+	// first search asked for, and shared by any made after it
+	if (algorithm == "bestfirst")
+	{
+		return new BestFirstSearch(g);
+	}
+	if (algorithm == "ucs")
+	{
+		return new UniformCostSearch(g);
+	}
+	if (algorithm == "astar")
+	{
+		return new AStarSearch(g);
+	}
+	if (algorithm == "alt")
+	{
+		if (landmarks.count() == 0)
+		{
+			loadLandmarks(filename, g, landmarks);
+		}
+		return new AStarSearch(g, landmarks);
+	}
+	if (algorithm == "bidirectional")
+	{
+		return new BidirectionalDijkstraSearch(g);
+	}
+	if (algorithm == "bidirectional-astar")
+	{
+		return new BidirectionalAStarSearch(g);
+	}
+	if (algorithm == "ch")
+	{
+		if (!hierarchy)
+		{
+			hierarchy.reset(new ContractionHierarchy(g));
+		}
+		return new ContractionHierarchySearch(g, *hierarchy);
+	}
+	if (algorithm == "cch")
+	{
+		if (!customizable)
+		{
+			customizable.reset(new CustomizableHierarchy(g));
+		}
+		return new CustomizableHierarchySearch(g, *customizable);
+	}
+	if (algorithm == "fixed")
+	{
+		if (!fixedCosts)
+		{
+			fixedCosts.reset(new FixedCosts(g));
+		}
+		return new FixedCostSearch(g, *fixedCosts);
+	}
+	return 0;
+}
+
+bool parseOption(const string& argument, const string& name, unsigned long& value)
+{
+	// an option of the form --name=value, for a whole number value. Returns
+	// false if the argument is not the named option, and throws if its value
+	// is not a number
+
+	const string prefix = "--" + name + "=";
+	if (argument.compare(0, prefix.size(), prefix) != 0)
+	{
+		return false;
+	}
+	const char* first = argument.data() + prefix.size();
+	const char* last = argument.data() + argument.size();
+	const from_chars_result result = from_chars(first, last, value);
+	if (first == last || result.ec != errc() || result.ptr != last)
+	{
+		throw invalid_argument("Did not recognize '" + argument + "' as an option");
+	}
+	return true;
+}
+
+int runBatch(int argc, char* argv[])
+{
+	// Batch mode : answers every query in a query file on one graph, with one
+	// search, and streams the results to standard output as CSV or JSON lines.
+	// Errors go to standard error, so the output stays machine readable.
+	// Given --threads, the queries are shared out between that many threads
+	// (0 for one per hardware thread), each with a search of its own, and the
+	// results written in the order of the queries all the same. Given --cache,
+	// a query asked again is answered from a RouteCache of up to that many
+	// routes (0 for none), and the cache's counts are written to standard error at the end.
+	//
+	//		Usage : search graphFile queryFile [algorithm] [csv|json] [--threads=N] [--cache=N]
+
+	const char* usage = " <graph file> <query file> [algorithm] [csv|json] [--threads=N] [--cache=N]";
+
+	// the options come after the other arguments
+	unsigned long threads = 1;
+	unsigned long cacheSize = 0;
+	bool threaded = false;
+	try
+	{
+		while (argc > 3 && string(argv[argc - 1]).compare(0, 2, "--") == 0)
+		{
+			const string option = argv[--argc];
+			if (parseOption(option, "threads", threads))
+			{
+				threaded = true;
+			}
+			else if (!parseOption(option, "cache", cacheSize))
+			{
+				throw invalid_argument("Unknown option " + option);
+			}
+		}
+	}
+	catch (std::exception& e)
+	{
+		cerr << e.what() << endl << "Usage: " << argv[0] << usage << endl;
+		return 1;
+	}
+
+	const string algorithm = (argc > 3) ? argv[3] : "astar";
+	ResultWriter::Format format = ResultWriter::CSV;
+	if (argc < 3 || argc > 5 || (argc > 4 && !ResultWriter::formatFromName(argv[4], format)))
+	{
+		cerr << "Usage: " << argv[0] << usage << endl;
+		return 1;
+	}
+
+	try
+	{
+		// load the graph and the queries once for the whole batch
+		const string filename = argv[1];
+		Graph g;
+		loadGraph(filename, g);
+
+		vector<BatchQuery> queries;
+		boost::shared_ptr<SpatialIndex> index;
+		readQueries(argv[2], g, queries, index);
+
+		Landmarks landmarks;
+		boost::shared_ptr<ContractionHierarchy> hierarchy;
+		boost::shared_ptr<CustomizableHierarchy> customizable;
+		boost::shared_ptr<FixedCosts> fixedCosts;
+		boost::shared_ptr<SearchBase> search(makeSearch(algorithm, filename, g, landmarks, hierarchy, customizable, fixedCosts));
+		if (!search)
+		{
+			cerr << "Unknown algorithm " << algorithm
+				<< ", choose from bestfirst, ucs, astar, alt, bidirectional, bidirectional-astar, ch, cch or fixed" << endl;
+			return 1;
+		}
+
+		ResultWriter writer(cout, format, g);
+		if (!threaded && cacheSize == 0)
+		{
+			Path path;
+			for (vector<BatchQuery>::const_iterator it = queries.cbegin(); it != queries.cend(); ++it)
+			{
+				search->findRoute(it->initial, it->goal, path);
+				writer.write(it->initial, it->goal, path, search->statistics());
+			}
+			return 0;
+		}
+
+		// every worker gets a search of its own, sharing the preprocessing
+		// already done for the first one. The queries go to the workers a
+		// block at a time, and each block is written out once it is done
+		BatchExecutor executor(g, [&]()
+		{
+			return makeSearch(algorithm, filename, g, landmarks, hierarchy, customizable, fixedCosts);
+		}, unsigned(threads));
+
+		// there is only the one search, so it is the cache's algorithm 0
+		boost::shared_ptr<RouteCache> cache;
+		if (cacheSize != 0)
+		{
+			cache.reset(new RouteCache(cacheSize));
+			executor.useCache(cache.get(), 0);
+		}
+
+		vector<BatchQuery> block;
+		vector<Path> paths;
+		vector<SearchStats> stats;
+		for (size_t begin = 0; begin < queries.size(); begin += BATCH_BLOCK_SIZE)
+		{
+			const size_t end = min(queries.size(), begin + BATCH_BLOCK_SIZE);
+			block.assign(queries.cbegin() + begin, queries.cbegin() + end);
+			executor.run(block, paths, stats);
+			for (size_t i = 0; i < block.size(); ++i)
+			{
+				writer.write(block[i].initial, block[i].goal, paths[i], stats[i]);
+			}
+		}
+
+		if (cache)
+		{
+			writer.flush();
+			const RouteCache::Counters counters = cache->counters();
+			cerr << "Route cache : " << counters.hits << " hits, " << counters.misses << " misses, "
+				<< counters.evictions << " evictions" << endl;
+		}
+	}
+
+	// catch any errors and quit
+	catch (std::exception& e)
+	{
+		cerr << e.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	// given a graph and a query file, run them as a batch, without prompting
+	if (argc > 1)
+	{
+		return runBatch(argc, argv);
+	}
+
 	// Prompt user for a file
 	string filename = getFilename();
 
@@ -35,7 +400,7 @@ int main()
 	{
 		// Create a graph instance, and read the file into it
 		Graph g;
-		g.readFile(filename.c_str());
+		loadGraph(filename, g);
 		g.print();					//print the graph, for fun
 	
 		// Print the list of nodes available for user to choose
@@ -73,6 +438,41 @@ int main()
 		#ifdef _WIN32
 			system("PAUSE");
 		#endif
+	
+		cout << "\nA STAR SEARCH WITH LANDMARKS\n----------------------------\n";
+		Landmarks landmarks;
+		loadLandmarks(filename, g, landmarks);
+		AStarSearch l = AStarSearch(g, landmarks);
+		l.search(startNode, goalNode);
+		
+		#ifdef _WIN32
+			system("PAUSE");
+		#endif
+	
+		cout << "\nBIDIRECTIONAL UNIFORM COST SEARCH\n---------------------------------\n";
+		BidirectionalDijkstraSearch d = BidirectionalDijkstraSearch(g);
+		d.search(startNode, goalNode);
+		
+		#ifdef _WIN32
+			system("PAUSE");
+		#endif
+	
+		cout << "\nBIDIRECTIONAL A STAR SEARCH\n---------------------------\n";
+		BidirectionalAStarSearch e = BidirectionalAStarSearch(g);
+		e.search(startNode, goalNode);
+		
+		#ifdef _WIN32
+			system("PAUSE");
+		#endif
+	
+		cout << "\nCONTRACTION HIERARCHY SEARCH\n----------------------------\n";
+		ContractionHierarchy hierarchy(g);
+		ContractionHierarchySearch f = ContractionHierarchySearch(g, hierarchy);
+		f.search(startNode, goalNode);
+		
+		#ifdef _WIN32
+			system("PAUSE");
+		#endif
 	}
 
 	// catch any errors and quit
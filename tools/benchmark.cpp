@@ -0,0 +1,505 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * benchmark.cpp
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#include "Graph.h"
+#include "GraphGenerator.h"
+#include "UniformCostSearch.h"
+#include "AStarSearch.h"
+#include "BestFirstSearch.h"
+#include "BidirectionalDijkstraSearch.h"
+#include "BidirectionalAStarSearch.h"
+#include "Landmarks.h"
+#include "ContractionHierarchy.h"
+#include "ContractionHierarchySearch.h"
+#include "CustomizableHierarchy.h"
+#include "CustomizableHierarchySearch.h"
+#include "DistanceMatrix.h"
+#include "BatchExecutor.h"
+#include "RouteCache.h"
+#include "FixedCostSearch.h"
+#include "SpatialIndex.h"
+
+using namespace std;
+
+// Runs one fixed set of route queries against each of the searches, on a graph
+// file or on a graph generated in memory (see GraphGenerator.h), and reports for
+// each search its queries per second, median and 99th percentile query time,
+// mean number of nodes settled and edges relaxed per query, and the peak
+// memory of the process so far. The queries are drawn from the seed, so a run
+// can be repeated exactly and compared with another build. Routes whose cost
+// differs from the uniform cost search's are counted as wrong. Best first
+// search and weighted A* are not exact, so only routes that cost more count
+// against them, and they are expected to have some.
+//
+// The uniform cost and A* searches are run again with the nodes renumbered
+// along a Hilbert curve, and breadth first. Last, a random traffic update is
+// applied to the edge costs, and the customizable hierarchy is timed taking it
+// in, then checked again.
+//
+// A distance matrix, from the initial nodes of the first queries to their goal
+// nodes, is timed with and without the contraction hierarchy, and each of its
+// cells checked against the uniform cost search's route between the two.
+//
+// The queries are also answered by a BatchExecutor, with a contraction
+// hierarchy search on each of 1, 2, 4... threads, up to one per hardware thread
+// but at least two, and the throughput of each checked against the uniform cost search's costs.
+//
+// Then a stream of repeated queries, some asked far more often than others, is
+// answered by customizable hierarchy searches through a RouteCache too small to
+// hold them all, and the cache's hits, misses and evictions reported. The cache
+// is invalidated with the traffic update, and the stream answered through it
+// again, so no route from before the update may be served after it.
+//
+//		Usage : benchmark graphFile [queryCount] [seed]
+//				benchmark grid|geometric|road nodeCount [queryCount] [seed]
+
+typedef chrono::steady_clock Clock;
+
+typedef BatchExecutor::Query Query;
+
+static double secondsSince(const Clock::time_point start)
+{
+	return chrono::duration<double>(Clock::now() - start).count();
+}
+
+static double peakMemoryMB()
+{
+	// the most memory the process has held at once, as far as the system can tell
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return 0.0;
+	}
+	return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0.0;
+	}
+#ifdef __APPLE__
+	return usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+	return usage.ru_maxrss / 1024.0;
+#endif
+#endif
+}
+
+static void printHeader()
+{
+	cout << left << setw(28) << "Search" << right
+		<< setw(12) << "queries/s" << setw(12) << "p50 ms" << setw(12) << "p99 ms"
+		<< setw(12) << "settled" << setw(12) << "relaxed" << setw(8) << "wrong" << setw(12) << "peak MB" << endl;
+}
+
+static bool isWrong(const float cost, const float reference, const bool exact = true)
+{
+	// a cost that differs from the reference cost by more than rounding, or only
+	// one that is more if the search is not exact
+	if (isinf(cost) || isinf(reference))
+	{
+		return isinf(cost) != isinf(reference);
+	}
+	return (exact ? fabs(cost - reference) : cost - reference) > 1e-4f * max(1.0f, reference);
+}
+
+static void runQueries(const string& name, SearchBase& search, const vector<Query>& queries, vector<float>& reference,
+	const bool exact = true)
+{
+	// times each query on its own, and checks its cost against the reference
+	// costs, which the first search run fills in. A route cheaper than the
+	// reference is wrong too, unless the search is not exact
+
+	const bool isReference = reference.empty();
+	vector<double> times(queries.size());
+	double totalTime = 0.0;
+	double totalSettled = 0.0;
+	double totalRelaxed = 0.0;
+	size_t wrong = 0;
+
+	for (size_t i = 0; i < queries.size(); ++i)
+	{
+		const Clock::time_point start = Clock::now();
+		const float cost = search.findRoute(queries[i].initial, queries[i].goal);
+		times[i] = secondsSince(start);
+
+		totalTime += times[i];
+		totalSettled += double(search.statistics().nodesSettled);
+		totalRelaxed += double(search.statistics().edgesRelaxed);
+
+		if (isReference)
+		{
+			reference.push_back(cost);
+		}
+		else if (isWrong(cost, reference[i], exact))
+		{
+			++wrong;
+		}
+	}
+
+	sort(times.begin(), times.end());
+	const size_t count = max<size_t>(1, queries.size());
+	const double p50 = times.empty() ? 0.0 : times[times.size() / 2];
+	const double p99 = times.empty() ? 0.0 : times[min(times.size() - 1, times.size() * 99 / 100)];
+
+	cout << left << setw(28) << name << right << fixed
+		<< setw(12) << setprecision(1) << (totalTime > 0.0 ? queries.size() / totalTime : 0.0)
+		<< setw(12) << setprecision(3) << p50 * 1000.0
+		<< setw(12) << setprecision(3) << p99 * 1000.0
+		<< setw(12) << setprecision(0) << totalSettled / count
+		<< setw(12) << setprecision(0) << totalRelaxed / count
+		<< setw(8) << wrong
+		<< setw(12) << setprecision(1) << peakMemoryMB() << endl;
+}
+
+static void runMatrix(const string& name, DistanceMatrix& matrix, const vector<nodeIndex>& sources,
+	const vector<nodeIndex>& targets, const vector<float>& reference)
+{
+	// times one matrix of costs, and checks every cell against the reference
+	vector<float> costs;
+	const Clock::time_point start = Clock::now();
+	matrix.compute(sources, targets, costs);
+	const double seconds = secondsSince(start);
+
+	size_t wrong = 0;
+	for (size_t i = 0; i < costs.size(); ++i)
+	{
+		wrong += isWrong(costs[i], reference[i]);
+	}
+
+	cout << left << setw(28) << name << right << fixed
+		<< setw(12) << setprecision(3) << seconds
+		<< setw(12) << setprecision(1) << (seconds > 0.0 ? costs.size() / seconds : 0.0)
+		<< setw(8) << wrong << endl;
+}
+
+static void runCached(const string& name, BatchExecutor& executor, const RouteCache& cache,
+	const vector<Query>& queries, const vector<size_t>& picks, const vector<float>& reference)
+{
+	// times a stream of queries answered through the cache, and checks the cost
+	// of each against the reference cost of the query it repeats
+	const RouteCache::Counters before = cache.counters();
+	vector<float> costs;
+	const Clock::time_point start = Clock::now();
+	executor.run(queries, costs);
+	const double seconds = secondsSince(start);
+	const RouteCache::Counters after = cache.counters();
+
+	size_t wrong = 0;
+	for (size_t i = 0; i < costs.size(); ++i)
+	{
+		wrong += isWrong(costs[i], reference[picks[i]]);
+	}
+
+	cout << left << setw(28) << name << right << fixed
+		<< setw(12) << setprecision(1) << (seconds > 0.0 ? queries.size() / seconds : 0.0)
+		<< setw(12) << after.hits - before.hits
+		<< setw(12) << after.misses - before.misses
+		<< setw(12) << after.evictions - before.evictions
+		<< setw(8) << wrong << endl;
+}
+
+static void printCacheHeader()
+{
+	cout << left << setw(28) << "Route cache" << right << setw(12) << "queries/s"
+		<< setw(12) << "hits" << setw(12) << "misses" << setw(12) << "evictions" << setw(8) << "wrong" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	GraphGenerator::Shape shape;
+	const bool generate = (argc >= 2) && GraphGenerator::shapeFromName(argv[1], shape);
+	const int firstOption = generate ? 3 : 2;
+
+	if (argc < firstOption || argc > firstOption + 2)
+	{
+		cout << "Usage: " << argv[0] << " <graph file> [query count] [seed]" << endl;
+		cout << "       " << argv[0] << " <grid|geometric|road> <node count> [query count] [seed]" << endl;
+		return 1;
+	}
+
+	try
+	{
+		const size_t queryCount = (argc > firstOption) ? strtoul(argv[firstOption], 0, 10) : 1000;
+		const uint32_t seed = (argc > firstOption + 1) ? uint32_t(strtoul(argv[firstOption + 1], 0, 10)) : 1;
+
+		// load or generate the graph
+		Graph g;
+		Clock::time_point start = Clock::now();
+		if (generate)
+		{
+			GraphGenerator(shape, nodeIndex(strtoul(argv[2], 0, 10)), seed).build(g);
+		}
+		else if (Graph::isBinaryFile(argv[1]))
+		{
+			g.readBinaryFile(argv[1]);
+		}
+		else
+		{
+			g.readFile(argv[1]);
+		}
+
+		cout << "Graph of " << g.nodeCount() << " nodes and " << g.edgeCount() << " edges, "
+			<< (generate ? "generated" : "loaded") << " in " << fixed << setprecision(2) << secondsSince(start) << "s" << endl;
+
+		if (g.nodeCount() == 0)
+		{
+			return 0;
+		}
+
+		// the query set depends only on the seed and the size of the graph
+		mt19937 random(seed);
+		vector<Query> queries(queryCount);
+		for (vector<Query>::iterator it = queries.begin(); it != queries.end(); ++it)
+		{
+			it->initial = nodeIndex(random() % g.nodeCount());
+			it->goal = nodeIndex(random() % g.nodeCount());
+		}
+
+		// preprocessing for the landmark and hierarchy searches
+		start = Clock::now();
+		Landmarks landmarks;
+		landmarks.build(g);
+		cout << "Landmarks: " << landmarks.count() << " built in " << setprecision(2) << secondsSince(start) << "s" << endl;
+
+		start = Clock::now();
+		ContractionHierarchy hierarchy(g);
+		cout << "Contraction hierarchy: " << hierarchy.shortcutCount() << " shortcuts built in "
+			<< setprecision(2) << secondsSince(start) << "s" << endl;
+
+		start = Clock::now();
+		CustomizableHierarchy customizable(g);
+		cout << "Customizable hierarchy: " << customizable.arcCount() << " arcs built in "
+			<< setprecision(2) << secondsSince(start) << "s" << endl;
+
+		// snapping positions near the query nodes to the nearest node
+		start = Clock::now();
+		SpatialIndex index(g);
+		const double indexTime = secondsSince(start);
+		size_t snapped = 0;
+		start = Clock::now();
+		for (vector<Query>::const_iterator it = queries.cbegin(); it != queries.cend(); ++it)
+		{
+			const Node position(g.nodeLatitude(it->goal) + 0.001f, g.nodeLongitude(it->goal) - 0.001f);
+			snapped += (index.nearest(position) != INVALID_NODE);
+		}
+		cout << "Spatial index: built in " << setprecision(2) << indexTime << "s, nearest node in "
+			<< setprecision(2) << secondsSince(start) * 1e6 / max<size_t>(1, snapped) << "us" << endl;
+
+		cout << "\n" << queries.size() << " queries, seed " << seed << "\n\n";
+		printHeader();
+
+		vector<float> reference;
+
+		UniformCostSearch ucs(g);
+		runQueries("Uniform Cost", ucs, queries, reference);
+
+		FixedCosts fixedCosts(g);
+		FixedCostSearch fixed(g, fixedCosts);
+		runQueries("Uniform Cost, fixed point", fixed, queries, reference);
+
+		AStarSearch astar(g);
+		runQueries("A*", astar, queries, reference);
+
+		AStarSearch bounded(g, Frontier::D_ARY_HEAP, DistanceKernel::BOUNDED);
+		runQueries("A* (bounded distance)", bounded, queries, reference);
+
+		AStarSearch alt(g, landmarks);
+		runQueries("A* with landmarks", alt, queries, reference);
+
+		GraphSearch<LandmarkEstimate, SumPriority> directAlt(g, LandmarkEstimate(landmarks));
+		runQueries("A* with landmarks, direct", directAlt, queries, reference);
+
+		GraphSearch<DistanceEstimate, WeightedSumPriority> weighted(g, DistanceEstimate(g), WeightedSumPriority(1.5f));
+		runQueries("Weighted A* (1.5)", weighted, queries, reference, false);
+
+		BestFirstSearch bestFirst(g);
+		runQueries("Best First", bestFirst, queries, reference, false);
+
+		BidirectionalDijkstraSearch bidirectional(g);
+		runQueries("Bidirectional Uniform Cost", bidirectional, queries, reference);
+
+		BidirectionalAStarSearch bidirectionalAStar(g);
+		runQueries("Bidirectional A*", bidirectionalAStar, queries, reference);
+
+		ContractionHierarchySearch ch(g, hierarchy);
+		runQueries("Contraction Hierarchies", ch, queries, reference);
+
+		CustomizableHierarchySearch cch(g, customizable);
+		runQueries("Customizable Hierarchy", cch, queries, reference);
+
+		// the same queries on copies of the graph with the nodes renumbered, which
+		// only changes how close together in memory a search's nodes are
+		for (int order = 0; order < 2; ++order)
+		{
+			Graph reordered(g);
+			reordered.reorderNodes(order == 0 ? Graph::HILBERT_ORDER : Graph::BREADTH_FIRST_ORDER);
+			const string suffix = (order == 0) ? ", Hilbert order" : ", BFS order";
+
+			vector<Query> renumbered(queries);
+			for (vector<Query>::iterator it = renumbered.begin(); it != renumbered.end(); ++it)
+			{
+				it->initial = reordered.findOriginalNode(it->initial);
+				it->goal = reordered.findOriginalNode(it->goal);
+			}
+
+			UniformCostSearch reorderedUcs(reordered);
+			runQueries("Uniform Cost" + suffix, reorderedUcs, renumbered, reference);
+			AStarSearch reorderedAStar(reordered);
+			runQueries("A*" + suffix, reorderedAStar, renumbered, reference);
+		}
+
+		// a distance matrix about as big as the query set, from the first queries'
+		// initial nodes to their goals, with the uniform cost search's route for
+		// each cell as the reference
+		const size_t side = min(queries.size(), size_t(sqrt(double(queries.size()))));
+		vector<nodeIndex> sources(side);
+		vector<nodeIndex> targets(side);
+		for (size_t i = 0; i < side; ++i)
+		{
+			sources[i] = queries[i].initial;
+			targets[i] = queries[i].goal;
+		}
+
+		vector<float> cellReference;
+		start = Clock::now();
+		for (size_t i = 0; i < side; ++i)
+		{
+			for (size_t j = 0; j < side; ++j)
+			{
+				cellReference.push_back(ucs.findRoute(sources[i], targets[j]));
+			}
+		}
+		const double cellTime = secondsSince(start);
+
+		cout << "\nDistance matrix of " << side << " x " << side << " nodes\n\n";
+		cout << left << setw(28) << "Matrix" << right << setw(12) << "seconds" << setw(12) << "cells/s" << setw(8) << "wrong" << endl;
+		cout << left << setw(28) << "Uniform Cost, cell by cell" << right
+			<< setw(12) << setprecision(3) << cellTime
+			<< setw(12) << setprecision(1) << (cellTime > 0.0 ? cellReference.size() / cellTime : 0.0)
+			<< setw(8) << 0 << endl;
+
+		DistanceMatrix trees(g);
+		runMatrix("Search trees", trees, sources, targets, cellReference);
+		DistanceMatrix buckets(g, hierarchy);
+		runMatrix("Contraction Hierarchies", buckets, sources, targets, cellReference);
+
+		// the queries shared out between more and more threads, at least two
+		cout << "\nBatches of " << queries.size() << " queries\n\n";
+		cout << left << setw(28) << "Threads" << right << setw(12) << "queries/s" << setw(12) << "speedup" << setw(8) << "wrong" << endl;
+		const unsigned hardwareThreads = max(2u, thread::hardware_concurrency());
+		double singleRate = 0.0;
+		for (unsigned threads = 1; ; threads = min(threads * 2, hardwareThreads))
+		{
+			BatchExecutor executor(g, [&g, &hierarchy]() { return new ContractionHierarchySearch(g, hierarchy); }, threads);
+			vector<float> costs;
+			start = Clock::now();
+			executor.run(queries, costs);
+			const double seconds = secondsSince(start);
+
+			size_t wrong = 0;
+			for (size_t i = 0; i < costs.size(); ++i)
+			{
+				wrong += isWrong(costs[i], reference[i]);
+			}
+
+			const double rate = (seconds > 0.0) ? queries.size() / seconds : 0.0;
+			singleRate = (threads == 1) ? rate : singleRate;
+			cout << left << setw(28) << ("Contraction Hierarchies, " + to_string(threads)) << right
+				<< setw(12) << setprecision(1) << rate
+				<< setw(12) << setprecision(2) << (singleRate > 0.0 ? rate / singleRate : 0.0)
+				<< setw(8) << wrong << endl;
+
+			if (threads == hardwareThreads)
+			{
+				break;
+			}
+		}
+
+		// four times as many queries as the query set, drawn from it with a skew
+		// towards its first queries, through a cache that holds a quarter of them
+		mt19937 repeatRandom(seed);
+		vector<size_t> picks(queries.size() * 4);
+		vector<Query> repeated(picks.size());
+		for (size_t i = 0; i < picks.size(); ++i)
+		{
+			picks[i] = repeatRandom() % (repeatRandom() % queries.size() + 1);
+			repeated[i] = queries[picks[i]];
+		}
+
+		RouteCache cache(max<size_t>(1, queries.size() / 4));
+		BatchExecutor cached(g, [&g, &customizable]() { return new CustomizableHierarchySearch(g, customizable); }, hardwareThreads);
+		cached.useCache(&cache, 0);
+
+		cout << "\n" << repeated.size() << " repeated queries, a cache of " << cache.capacity() << " routes\n\n";
+		printCacheHeader();
+		runCached("Customizable", cached, cache, repeated, picks, reference);
+
+		// a traffic update: one edge in a hundred becomes up to three times as
+		// slow, and the customizable hierarchy takes in the new costs
+		vector<Graph::CostUpdate> updates;
+		for (edgeIndex e = 0; e < g.edgeCount(); ++e)
+		{
+			if (random() % 100 == 0)
+			{
+				const Graph::CostUpdate update = { e, g.edgeCost(e) * (1.0f + float(random() % 2000) / 1000.0f) };
+				updates.push_back(update);
+			}
+		}
+
+		start = Clock::now();
+		g.updateEdgeCosts(updates);
+		const double updateTime = secondsSince(start);
+		cache.invalidate();
+		start = Clock::now();
+		customizable.customize();
+		cout << "\nUpdated " << updates.size() << " edge costs in " << setprecision(3) << updateTime
+			<< "s, customized again in " << secondsSince(start) << "s\n\n";
+		fixedCosts.refresh();
+
+		// the uniform cost search gives the new reference costs
+		printHeader();
+		reference.clear();
+		runQueries("Uniform Cost (updated)", ucs, queries, reference);
+		runQueries("Customizable (updated)", cch, queries, reference);
+		runQueries("Fixed point (updated)", fixed, queries, reference);
+
+		// every route cached before the update is stale now
+		cout << "\n";
+		printCacheHeader();
+		runCached("Customizable (updated)", cached, cache, repeated, picks, reference);
+	}
+
+	// catch any errors and quit
+	catch (std::exception& e)
+	{
+		cout << e.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
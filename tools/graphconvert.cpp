@@ -0,0 +1,85 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * graphconvert.cpp
+ */
+
+#include <iostream>
+#include <exception>
+#include <string>
+#include <cstdlib>
+
+#include "Graph.h"
+#include "Landmarks.h"
+
+using namespace std;
+
+// Converts a graph from the text format read by Graph::readFile() into the
+// binary format mapped by Graph::readBinaryFile(). Given a node order, it
+// first renumbers the nodes in that order (see Graph::reorderNodes()). Given
+// a landmark count, it also computes landmark tables for the graph, and writes
+// them beside it to output.graph.landmarks, where the search program looks
+// for them.
+//
+//		Usage : graphconvert input.txt output.graph [landmark count] [hilbert|bfs]
+
+int main(int argc, char* argv[])
+{
+	// the options can come in either order
+	Graph::NodeOrder order = Graph::HILBERT_ORDER;
+	bool reorder = false;
+	int landmarkCount = 0;
+	for (int i = 3; i < argc; ++i)
+	{
+		if (!reorder && Graph::nodeOrderFromName(argv[i], order))
+		{
+			reorder = true;
+		}
+		else if (landmarkCount == 0 && atoi(argv[i]) > 0)
+		{
+			landmarkCount = atoi(argv[i]);
+		}
+		else
+		{
+			argc = 0;
+		}
+	}
+
+	if (argc < 3 || argc > 5)
+	{
+		cout << "Usage: " << argv[0] << " <input text graph> <output binary graph> [landmark count] [hilbert|bfs]" << endl;
+		return 1;
+	}
+
+	try
+	{
+		Graph g;
+		g.readFile(argv[1]);
+		if (reorder)
+		{
+			g.reorderNodes(order);
+		}
+		g.writeBinaryFile(argv[2]);
+
+		cout << "Wrote " << g.nodeCount() << " nodes and " << g.edgeCount() << " edges to " << argv[2] << endl;
+
+		if (landmarkCount > 0)
+		{
+			const string landmarkFile = string(argv[2]) + ".landmarks";
+			Landmarks landmarks;
+			landmarks.build(g, unsigned(landmarkCount));
+			landmarks.writeFile(landmarkFile);
+
+			cout << "Wrote " << landmarks.count() << " landmarks to " << landmarkFile << endl;
+		}
+	}
+
+	// catch any errors and quit
+	catch (std::exception& e)
+	{
+		cout << e.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,48 @@
+/*
+ * (C) 2014 Douglas Sievers
+ *
+ * graphgen.cpp
+ */
+
+#include <iostream>
+#include <exception>
+#include <string>
+#include <cstdlib>
+
+#include "GraphGenerator.h"
+
+using namespace std;
+
+// Generates a synthetic graph (see GraphGenerator.h) and writes it in the text
+// format read by Graph::readFile(), for the search program, graphconvert or
+// the benchmark. The same arguments always give the same graph.
+//
+//		Usage : graphgen grid|geometric|road nodeCount output.txt [seed]
+
+int main(int argc, char* argv[])
+{
+	GraphGenerator::Shape shape;
+	if ((argc != 4 && argc != 5) || !GraphGenerator::shapeFromName(argv[1], shape))
+	{
+		cout << "Usage: " << argv[0] << " <grid|geometric|road> <node count> <output text graph> [seed]" << endl;
+		return 1;
+	}
+
+	try
+	{
+		const unsigned long seed = (argc == 5) ? strtoul(argv[4], 0, 10) : 1;
+		GraphGenerator generator(shape, nodeIndex(strtoul(argv[2], 0, 10)), uint32_t(seed));
+		generator.writeFile(argv[3]);
+
+		cout << "Wrote " << generator.nodeCount() << " nodes and " << generator.edgeCount() << " edges to " << argv[3] << endl;
+	}
+
+	// catch any errors and quit
+	catch (std::exception& e)
+	{
+		cout << e.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}